@@ -0,0 +1,75 @@
+# builds the read-only data files into the game as a table of assets
+#
+# run in script mode:
+#   cmake -DOUTPUT=<assets.c> -DINPUTS=<file;file;...> -P embed_assets.cmake
+#
+# each file becomes a byte array, along with the offset of the start of
+# every line (plus the end of the last one), so the help pager can go
+# straight to any page; the table is sorted by file name so that
+# find_asset() can binary search it
+# carriage returns are dropped, as they would be by reading in text mode
+
+set(HZMORIA_ASSET_NAMES "")
+foreach(HZMORIA_ASSET_FILE ${INPUTS})
+  get_filename_component(HZMORIA_TEMP_NAME "${HZMORIA_ASSET_FILE}" NAME)
+  list(APPEND HZMORIA_ASSET_NAMES "${HZMORIA_TEMP_NAME}")
+  set(HZMORIA_ASSET_PATH_${HZMORIA_TEMP_NAME} "${HZMORIA_ASSET_FILE}")
+endforeach()
+list(SORT HZMORIA_ASSET_NAMES)
+
+set(HZMORIA_TEMP_OUT
+"/* assets.c: generated by cmake/embed_assets.cmake, do not edit */
+
+#include \"config.h\"
+#include \"types.h\"
+")
+set(HZMORIA_ASSET_TABLE "")
+set(HZMORIA_ASSET_INDEX 0)
+foreach(HZMORIA_TEMP_NAME ${HZMORIA_ASSET_NAMES})
+  file(READ "${HZMORIA_ASSET_PATH_${HZMORIA_TEMP_NAME}}" HZMORIA_TEMP_HEX HEX)
+  string(REGEX MATCHALL ".." HZMORIA_TEMP_BYTES "${HZMORIA_TEMP_HEX}")
+  list(REMOVE_ITEM HZMORIA_TEMP_BYTES "0d")
+  set(HZMORIA_TEMP_DATA "")
+  set(HZMORIA_TEMP_LINES "0")
+  set(HZMORIA_TEMP_COUNT 0)
+  set(HZMORIA_TEMP_POS 0)
+  set(HZMORIA_TEMP_LAST "")
+  foreach(HZMORIA_TEMP_BYTE ${HZMORIA_TEMP_BYTES})
+    string(APPEND HZMORIA_TEMP_DATA "0x${HZMORIA_TEMP_BYTE},")
+    math(EXPR HZMORIA_TEMP_POS "${HZMORIA_TEMP_POS} + 1")
+    math(EXPR HZMORIA_TEMP_COL "${HZMORIA_TEMP_POS} % 16")
+    if(HZMORIA_TEMP_COL EQUAL 0)
+      string(APPEND HZMORIA_TEMP_DATA "\n  ")
+    endif()
+    set(HZMORIA_TEMP_LAST "${HZMORIA_TEMP_BYTE}")
+    if(HZMORIA_TEMP_BYTE STREQUAL "0a")
+      string(APPEND HZMORIA_TEMP_LINES ", ${HZMORIA_TEMP_POS}")
+      math(EXPR HZMORIA_TEMP_COUNT "${HZMORIA_TEMP_COUNT} + 1")
+    endif()
+  endforeach()
+  # a last line without a newline still counts
+  if(HZMORIA_TEMP_POS GREATER 0 AND NOT HZMORIA_TEMP_LAST STREQUAL "0a")
+    string(APPEND HZMORIA_TEMP_LINES ", ${HZMORIA_TEMP_POS}")
+    math(EXPR HZMORIA_TEMP_COUNT "${HZMORIA_TEMP_COUNT} + 1")
+  endif()
+  string(APPEND HZMORIA_TEMP_OUT "
+/* ${HZMORIA_TEMP_NAME} */
+static char const asset_text_${HZMORIA_ASSET_INDEX}[] = {
+  ${HZMORIA_TEMP_DATA}0
+};
+static int32u const asset_lines_${HZMORIA_ASSET_INDEX}[] = {
+  ${HZMORIA_TEMP_LINES}
+};
+")
+  string(APPEND HZMORIA_ASSET_TABLE
+    "  {\"${HZMORIA_TEMP_NAME}\", asset_text_${HZMORIA_ASSET_INDEX}, "
+    "asset_lines_${HZMORIA_ASSET_INDEX}, ${HZMORIA_TEMP_COUNT}},\n")
+  math(EXPR HZMORIA_ASSET_INDEX "${HZMORIA_ASSET_INDEX} + 1")
+endforeach()
+string(APPEND HZMORIA_TEMP_OUT "
+asset_type const assets[] = {
+${HZMORIA_ASSET_TABLE}};
+int const asset_count = ${HZMORIA_ASSET_INDEX};
+")
+
+file(WRITE "${OUTPUT}" "${HZMORIA_TEMP_OUT}")
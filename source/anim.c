@@ -0,0 +1,128 @@
+/* source/anim.c: bolt, ball and missile animation
+
+   Projectiles used to draw themselves and refresh the screen at every
+   square they crossed, which over a slow or remote terminal meant one
+   round trip per square.  Instead, the squares a projectile is seen to
+   cross are queued up as frames while its flight is worked out, and are
+   played back together by anim_flush() before anything the projectile
+   hits is reported.  Each frame puts back whatever the previous frame
+   covered, draws its own characters, and is shown for anim_delay
+   milliseconds (set from the MORIA_ANIM_DELAY environment variable).
+
+   When there is no delay (the default), the steps before the last could
+   not be seen anyway, so only the last frame is drawn, with one refresh.
+   anim_show() leaves the last frame on the screen, so that the area of a
+   ball or breath stays in view while its damage is reported, until the
+   caller puts the squares back.  When the "Skip missile and spell
+   animations" option is set, or while the journal is being replayed,
+   nothing is drawn at all. */
+
+#include "config.h"
+
+#if defined(_MSC_VER) || defined(__MINGW32__) /* Windows */
+# ifdef _MSC_VER /* Visual Studio */
+#  include <curses.h>
+# else
+#  include <pdcurses.h> /* MinGW32 etc. */
+# endif
+#else /* everything else (*nix etc.) */
+# include <ncurses.h>
+#endif
+
+#include "externs.h"
+
+#include <stdlib.h>
+
+#define ANIM_FRAMES 32 /* enough for any bolt or missile flight */
+#define ANIM_CELLS  64 /* enough for a bolt plus a whole explosion */
+#define ANIM_MAX_DELAY 1000
+
+static int anim_delay = 0;
+static int anim_frames = 0, anim_cells = 0;
+/* frame f is made up of cells anim_first[f] .. anim_first[f+1]-1 */
+static int anim_first[ANIM_FRAMES + 1];
+static int anim_y[ANIM_CELLS], anim_x[ANIM_CELLS];
+static int anim_ch[ANIM_CELLS];
+
+/* Read the frame delay from MORIA_ANIM_DELAY, if set */
+void anim_init()
+{
+  char *p = getenv("MORIA_ANIM_DELAY");
+
+  if (p == CNIL || *p == '\0') return;
+  anim_delay = atoi(p);
+  if (anim_delay < 0) anim_delay = 0;
+  else if (anim_delay > ANIM_MAX_DELAY) anim_delay = ANIM_MAX_DELAY;
+}
+
+/* Put back what the given frame covered */
+static void anim_erase(const int f)
+{
+  int c;
+
+  for (c = anim_first[f]; c < anim_first[f + 1]; c++)
+    lite_spot(anim_y[c], anim_x[c]);
+}
+
+/* Start a new, empty frame */
+void anim_frame()
+{
+  if (anim_frames == ANIM_FRAMES) anim_flush();
+  anim_frames++;
+  anim_first[anim_frames] = anim_cells;
+}
+
+/* Add a character at row, col to the current frame, starting one if
+   there is none */
+void anim_cell(const int ch, const int row, const int col)
+{
+  if (anim_cells == ANIM_CELLS) anim_flush();
+  if (anim_frames == 0) anim_frame();
+  anim_y[anim_cells] = row;
+  anim_x[anim_cells] = col;
+  anim_ch[anim_cells] = ch;
+  anim_cells++;
+  anim_first[anim_frames] = anim_cells;
+}
+
+/* Play the queued frames, one refresh and anim_delay milliseconds each,
+   or just the last one if there is no delay; unless hold is set, then put
+   back what the last one covered. */
+static void anim_play(const bool hold)
+{
+  int f, c;
+
+  if (anim_frames == 0) return;
+  if (!skip_anim_flag && !journal_replaying())
+  {
+    for (f = (anim_delay > 0) ? 0 : anim_frames - 1; f < anim_frames; f++)
+    {
+      if (anim_delay > 0 && f > 0) anim_erase(f - 1);
+      for (c = anim_first[f]; c < anim_first[f + 1]; c++)
+        print(anim_ch[c], anim_y[c], anim_x[c]);
+      put_qio();
+      if (anim_delay > 0) (void) napms(anim_delay);
+    }
+    if (!hold)
+    {
+      /* without a delay, the last frame stays until the next refresh */
+      anim_erase(anim_frames - 1);
+      if (anim_delay > 0) put_qio();
+    }
+  }
+  anim_frames = 0;
+  anim_cells = 0;
+}
+
+/* Play the queued frames, and put back what the last one covered */
+void anim_flush()
+{
+  anim_play(false);
+}
+
+/* Play the queued frames, leaving the last one on the screen for the
+   caller to put back with lite_spot() */
+void anim_show()
+{
+  anim_play(true);
+}
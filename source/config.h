@@ -108,7 +108,7 @@
    Start at 6.x to signal that we're carrying on from UMoria 5.6 */
 #define CUR_VERSION_MAJ 6
 #define CUR_VERSION_MIN 0
-#define PATCH_LEVEL     0
+#define PATCH_LEVEL     1
 
 #define MAX_UCHAR 255
 #define MAX_SHORT 32767       /* maximum short/long signed ints */
@@ -117,15 +117,44 @@
 /* Changing values below this line may be hazardous to your health! */
 
 #define MSG_LINE      0  /* message line location */
-#define MAX_SAVE_MSG  22 /* number of messages to save in a buffer */
+#define MAX_SAVE_MSG  22 /* number of messages in savefiles before 6.0.1 */
+#define MSG_LOG_TEXTS 65535 /* most different messages the log can hold */
 
 /* Dungeon size parameters */
-#define MAX_HEIGHT    66  /* Multiple of 11; >= 22 */
-#define MAX_WIDTH     198 /* Multiple of 33; >= 66 */
+#ifdef LARGE_DUNGEON
+/* The experimental megadungeon build: each level is DUN_SCALE times as
+   high and as wide as usual, with room for as many more rooms, objects
+   and monsters.  Map coordinates and the monster and object indices kept
+   in the cave are then stored in 16 bits (see dcoord and dindex in
+   types.h), so savefiles from the two builds can not be exchanged; each
+   savefile records which build wrote it (SV_LARGE_DUNGEON), and each build
+   refuses the other's. */
+#define DUN_SCALE     3
+#else
+#define DUN_SCALE     1
+#endif
+#define MAX_HEIGHT    (66 * DUN_SCALE)  /* Multiple of 11; >= 22 */
+#define MAX_WIDTH     (198 * DUN_SCALE) /* Multiple of 33; >= 66 */
+/* Cave flag bit planes: a row of MAX_WIDTH bits in 64 bit words.  Setting
+   or clearing a flag may change the square's symbol, so it also tells the
+   screen_map() overview, which may be showing it even if the map is not. */
+#define CAVE_WORDS    ((MAX_WIDTH + 63) / 64)
+#define CAVE_BIT(x)   ((int64u)1 << ((x) & 63))
+#define cave_flag(plane, y, x) (((plane)[y][(x) >> 6] & CAVE_BIT(x)) != 0)
+#define cave_on(plane, y, x) \
+  ((plane)[y][(x) >> 6] |= CAVE_BIT(x), screen_map_spot(y, x))
+#define cave_off(plane, y, x) \
+  ((plane)[y][(x) >> 6] &= ~CAVE_BIT(x), screen_map_spot(y, x))
+#define cave_put(plane, y, x, v) \
+  ((v) ? cave_on(plane, y, x) : cave_off(plane, y, x))
 #define SCREEN_HEIGHT 22
 #define SCREEN_WIDTH  66
 #define QUART_HEIGHT  (SCREEN_HEIGHT / 4)
 #define QUART_WIDTH   (SCREEN_WIDTH / 4)
+/* The map view grows with the terminal, from SCREEN_HEIGHT by SCREEN_WIDTH
+   up to the size of a whole normal level, and scrolls by half its size */
+#define VIEW_MAX_HEIGHT 66
+#define VIEW_MAX_WIDTH  198
 
 /* Dungeon generation values */
 /* Note: The entire design of dungeon can be changed by only
@@ -133,14 +162,14 @@
 #define DUN_TUN_RND   9   /* 1/Chance of Random direction          */
 #define DUN_TUN_CHG   70  /* Chance of changing direction (99 max) */
 #define DUN_TUN_CON   15  /* Chance of extra tunneling             */
-#define DUN_ROO_MEA   32  /* Mean of # of rooms, standard dev2     */
+#define DUN_ROO_MEA   (32 * DUN_SCALE * DUN_SCALE) /* Mean of # of rooms, standard dev2 */
 #define DUN_TUN_PEN   25  /* % chance of room doors                */
 #define DUN_TUN_JCT   15  /* % chance of doors at tunnel junctions */
 #define DUN_STR_DEN   5   /* Density of streamers                  */
 #define DUN_STR_RNG   2   /* Width of streamers                    */
-#define DUN_STR_MAG   3   /* Number of magma streamers             */
+#define DUN_STR_MAG   (3 * DUN_SCALE) /* Number of magma streamers  */
 #define DUN_STR_MC    90  /* 1/x chance of treasure per magma      */
-#define DUN_STR_QUA   2   /* Number of quartz streamers            */
+#define DUN_STR_QUA   (2 * DUN_SCALE) /* Number of quartz streamers */
 #define DUN_STR_QC    40  /* 1/x chance of treasure per quartz     */
 #define DUN_UNUSUAL   300 /* Level/x chance of unusual room        */
 
@@ -152,7 +181,15 @@
 #define STORE_MAX_INVEN   18  /* Max diff objs in stock for auto buy   */
 #define STORE_MIN_INVEN   10  /* Min diff objs in stock for auto sell  */
 #define STORE_TURN_AROUND 9   /* Amount of buying and selling normally */
+#define STORE_MAX_PENDING 10  /* Max turnovers put off till back in town */
 #define COST_ADJ          100 /* Adjust prices for buying and selling  */
+/* base price of object_list[i], the table itself is read-only so the
+   adjustment is made as it's read; round half-way cases up */
+#if (COST_ADJ != 100)
+#define object_cost(i) (((object_list[i].cost * COST_ADJ) + 50) / 100)
+#else
+#define object_cost(i) (object_list[i].cost)
+#endif
 
 /* Treasure constants */
 #define INVEN_ARRAY_SIZE 34 /* Size of inventory array(Do not change) */
@@ -182,11 +219,11 @@
 #define MAX_GOLD          18  /* Number of different types of gold    */
 /* with MAX_TALLOC 150, it is possible to get compacting objects during
    level generation, although it is extremely rare */
-#define MAX_TALLOC        175 /* Max objects per level                */
+#define MAX_TALLOC        (175 * DUN_SCALE * DUN_SCALE) /* Max objects per level */
 #define MIN_TRIX          1   /* Minimum t_list index used            */
-#define TREAS_ROOM_ALLOC  7   /* Amount of objects for rooms          */
-#define TREAS_ANY_ALLOC   2   /* Amount of objects for corridors      */
-#define TREAS_GOLD_ALLOC  2   /* Amount of gold (and gems)            */
+#define TREAS_ROOM_ALLOC  (7 * DUN_SCALE * DUN_SCALE) /* Amount of objects for rooms */
+#define TREAS_ANY_ALLOC   (2 * DUN_SCALE * DUN_SCALE) /* Amount of objects for corridors */
+#define TREAS_GOLD_ALLOC  (2 * DUN_SCALE * DUN_SCALE) /* Amount of gold (and gems) */
 
 /* Magic Treasure Generation constants */
 /* Note: Number of special objects, and degree of enchantments
@@ -202,6 +239,7 @@
 /* Constants describing limits of certain objects */
 #define OBJ_LAMP_MAX   15000 /* Maximum amount that lamp can be filled */
 #define OBJ_BOLT_RANGE 18    /* Maximum range of bolts and balls       */
+#define OBJ_BALL_RADIUS 2    /* Radius of ball and breath explosions   */
 #define OBJ_RUNE_PROT  3000  /* Rune of protection resistance          */
 
 /* Creature constants */
@@ -209,15 +247,16 @@
 #define N_MONS_ATTS       215 /* Number of monster attack types.             */
 /* with MAX_MALLOC 101, it is possible to get compacting monsters messages
    while breeding/cloning monsters */
-#define MAX_MALLOC        125 /* Max that can be allocated                   */
+#define MAX_MALLOC        (125 * DUN_SCALE * DUN_SCALE) /* Max that can be allocated */
 #define MAX_MALLOC_CHANCE 160 /* 1/x chance of new monster each round        */
 #define MAX_MONS_LEVEL    40  /* Maximum level of creatures                  */
 #define MAX_SIGHT         20  /* Maximum dis a creature can be seen          */
+#define FLOW_RANGE        40  /* Max steps monsters follow the flow field    */
 #define MAX_SPELL_DIS     20  /* Maximum dis creat. spell can be cast        */
 #define MAX_MON_MULT      75  /* Maximum reproductions on a level            */
 #define MON_MULT_ADJ      7   /* High value slows multiplication             */
 #define MON_NASTY         50  /* 1/x chance of high level creat              */
-#define MIN_MALLOC_LEVEL  14  /* Minimum number of monsters/level            */
+#define MIN_MALLOC_LEVEL  (14 * DUN_SCALE * DUN_SCALE) /* Minimum number of monsters/level */
 #define MIN_MALLOC_TD     4   /* Number of people on town level (day)        */
 #define MIN_MALLOC_TN     8   /* Number of people on town level (night)      */
 #define WIN_MON_TOT       2   /* Total number of "win" creatures             */
@@ -334,6 +373,8 @@
 
 /* Column for stats */
 #define STAT_COLUMN 0
+/* Row for the status line, just below the map view */
+#define STATUS_ROW (view_height + 1)
 
 /* Class spell types */
 #define NONE   0
@@ -687,6 +728,11 @@
 #define SV_FIND_IGNORE_DOORS   0x00000100L
 #define SV_SOUND_BEEP_FLAG     0x00000200L
 #define SV_DISPLAY_COUNTS      0x00000400L
+#define SV_SKIP_ANIM           0x00000800L
+#define SV_SMART_PATH          0x00001000L
+#define SV_LAZY_STORES         0x00002000L
+#define SV_LARGE_DUNGEON       0x20000000L /* written by the LARGE_DUNGEON
+                                              build */
 #define SV_TOTAL_WINNER        0x40000000L
 #define SV_DEATH               0x80000000L /* sign bit */
 
@@ -695,4 +741,34 @@
 #define NS_WIZARD      0x2
 #define NS_DUPLICATE   0x4
 
+/* outside events recorded in the crash recovery journal */
+#define JE_INTERRUPT 1 /* key pressed to interrupt a rest, run or repeat */
+#define JE_CLOSING   2 /* game hours have run out */
+#define JE_CRASH     3 /* the game crashed, followed by where the command
+                          it crashed in starts in the journal */
+#define JE_REPLAY_CRASH 4 /* the game crashed while replaying the journal */
+#define JE_EOF       5 /* end of input where a key was expected */
+
+/* hot path profiling counters, only kept when built with PROFILE */
+#define PROF_CREATURES       0
+#define PROF_UPDATE_MON      1
+#define PROF_LOS             2
+#define PROF_PRT_MAP         3
+#define PROF_GENERATE_CAVE   4
+#define PROF_SAVE_CHAR       5
+#define PROF_COMPACT_OBJECTS 6
+#define PROF_PUSHT           7
+#define PROF_PUT_QIO         8
+#define PROF_MAX             9
+
+/* gameplay events written to the MORIA_EVENTS log */
+#define EV_KILL     0
+#define EV_DAMAGE   1
+#define EV_LEVEL    2
+#define EV_PICKUP   3
+#define EV_IDENTIFY 4
+#define EV_PURCHASE 5
+#define EV_DEATH    6
+#define EV_MAX      7
+
 #endif /* CONFIG_H */
@@ -1,5 +1,7 @@
 #include "cp437utf.h"
 
+#include <string.h>
+
 const cchar_t cp437utf[256] = { \
   0x0000, 0x263A, 0x263B, 0x2665, 0x2666, 0x2663, 0x2660, 0x2022, 0x25D8, 0x25CB, 0x25D9, 0x2642, 0x2640, 0x266A, 0x266B, 0x263C, \
   0x25BA, 0x25C4, 0x2195, 0x203C, 0x00B6, 0x00A7, 0x25AC, 0x21A8, 0x2191, 0x2193, 0x2192, 0x2190, 0x221F, 0x2194, 0x25B2, 0x25BC, \
@@ -19,6 +21,92 @@ const cchar_t cp437utf[256] = { \
   0x2261, 0x00B1, 0x2265, 0x2264, 0x2320, 0x2321, 0x00F7, 0x2248, 0x00B0, 0x2219, 0x00B7, 0x221A, 0x207F, 0x00B2, 0x25A0, 0x00A0
 };
 
+const unsigned char cp437utf8[256][4] = {
+  {0x00, 0x00, 0x00, 0x00}, {0xE2, 0x98, 0xBA, 0x00}, {0xE2, 0x98, 0xBB, 0x00}, {0xE2, 0x99, 0xA5, 0x00}, /* 0x00 */
+  {0xE2, 0x99, 0xA6, 0x00}, {0xE2, 0x99, 0xA3, 0x00}, {0xE2, 0x99, 0xA0, 0x00}, {0xE2, 0x80, 0xA2, 0x00}, /* 0x04 */
+  {0xE2, 0x97, 0x98, 0x00}, {0xE2, 0x97, 0x8B, 0x00}, {0xE2, 0x97, 0x99, 0x00}, {0xE2, 0x99, 0x82, 0x00}, /* 0x08 */
+  {0xE2, 0x99, 0x80, 0x00}, {0xE2, 0x99, 0xAA, 0x00}, {0xE2, 0x99, 0xAB, 0x00}, {0xE2, 0x98, 0xBC, 0x00}, /* 0x0C */
+  {0xE2, 0x96, 0xBA, 0x00}, {0xE2, 0x97, 0x84, 0x00}, {0xE2, 0x86, 0x95, 0x00}, {0xE2, 0x80, 0xBC, 0x00}, /* 0x10 */
+  {0xC2, 0xB6, 0x00, 0x00}, {0xC2, 0xA7, 0x00, 0x00}, {0xE2, 0x96, 0xAC, 0x00}, {0xE2, 0x86, 0xA8, 0x00}, /* 0x14 */
+  {0xE2, 0x86, 0x91, 0x00}, {0xE2, 0x86, 0x93, 0x00}, {0xE2, 0x86, 0x92, 0x00}, {0xE2, 0x86, 0x90, 0x00}, /* 0x18 */
+  {0xE2, 0x88, 0x9F, 0x00}, {0xE2, 0x86, 0x94, 0x00}, {0xE2, 0x96, 0xB2, 0x00}, {0xE2, 0x96, 0xBC, 0x00}, /* 0x1C */
+  {0x20, 0x00, 0x00, 0x00}, {0x21, 0x00, 0x00, 0x00}, {0x22, 0x00, 0x00, 0x00}, {0x23, 0x00, 0x00, 0x00}, /* 0x20 */
+  {0x24, 0x00, 0x00, 0x00}, {0x25, 0x00, 0x00, 0x00}, {0x26, 0x00, 0x00, 0x00}, {0x27, 0x00, 0x00, 0x00}, /* 0x24 */
+  {0x28, 0x00, 0x00, 0x00}, {0x29, 0x00, 0x00, 0x00}, {0x2A, 0x00, 0x00, 0x00}, {0x2B, 0x00, 0x00, 0x00}, /* 0x28 */
+  {0x2C, 0x00, 0x00, 0x00}, {0x2D, 0x00, 0x00, 0x00}, {0x2E, 0x00, 0x00, 0x00}, {0x2F, 0x00, 0x00, 0x00}, /* 0x2C */
+  {0x30, 0x00, 0x00, 0x00}, {0x31, 0x00, 0x00, 0x00}, {0x32, 0x00, 0x00, 0x00}, {0x33, 0x00, 0x00, 0x00}, /* 0x30 */
+  {0x34, 0x00, 0x00, 0x00}, {0x35, 0x00, 0x00, 0x00}, {0x36, 0x00, 0x00, 0x00}, {0x37, 0x00, 0x00, 0x00}, /* 0x34 */
+  {0x38, 0x00, 0x00, 0x00}, {0x39, 0x00, 0x00, 0x00}, {0x3A, 0x00, 0x00, 0x00}, {0x3B, 0x00, 0x00, 0x00}, /* 0x38 */
+  {0x3C, 0x00, 0x00, 0x00}, {0x3D, 0x00, 0x00, 0x00}, {0x3E, 0x00, 0x00, 0x00}, {0x3F, 0x00, 0x00, 0x00}, /* 0x3C */
+  {0x40, 0x00, 0x00, 0x00}, {0x41, 0x00, 0x00, 0x00}, {0x42, 0x00, 0x00, 0x00}, {0x43, 0x00, 0x00, 0x00}, /* 0x40 */
+  {0x44, 0x00, 0x00, 0x00}, {0x45, 0x00, 0x00, 0x00}, {0x46, 0x00, 0x00, 0x00}, {0x47, 0x00, 0x00, 0x00}, /* 0x44 */
+  {0x48, 0x00, 0x00, 0x00}, {0x49, 0x00, 0x00, 0x00}, {0x4A, 0x00, 0x00, 0x00}, {0x4B, 0x00, 0x00, 0x00}, /* 0x48 */
+  {0x4C, 0x00, 0x00, 0x00}, {0x4D, 0x00, 0x00, 0x00}, {0x4E, 0x00, 0x00, 0x00}, {0x4F, 0x00, 0x00, 0x00}, /* 0x4C */
+  {0x50, 0x00, 0x00, 0x00}, {0x51, 0x00, 0x00, 0x00}, {0x52, 0x00, 0x00, 0x00}, {0x53, 0x00, 0x00, 0x00}, /* 0x50 */
+  {0x54, 0x00, 0x00, 0x00}, {0x55, 0x00, 0x00, 0x00}, {0x56, 0x00, 0x00, 0x00}, {0x57, 0x00, 0x00, 0x00}, /* 0x54 */
+  {0x58, 0x00, 0x00, 0x00}, {0x59, 0x00, 0x00, 0x00}, {0x5A, 0x00, 0x00, 0x00}, {0x5B, 0x00, 0x00, 0x00}, /* 0x58 */
+  {0x5C, 0x00, 0x00, 0x00}, {0x5D, 0x00, 0x00, 0x00}, {0x5E, 0x00, 0x00, 0x00}, {0x5F, 0x00, 0x00, 0x00}, /* 0x5C */
+  {0x60, 0x00, 0x00, 0x00}, {0x61, 0x00, 0x00, 0x00}, {0x62, 0x00, 0x00, 0x00}, {0x63, 0x00, 0x00, 0x00}, /* 0x60 */
+  {0x64, 0x00, 0x00, 0x00}, {0x65, 0x00, 0x00, 0x00}, {0x66, 0x00, 0x00, 0x00}, {0x67, 0x00, 0x00, 0x00}, /* 0x64 */
+  {0x68, 0x00, 0x00, 0x00}, {0x69, 0x00, 0x00, 0x00}, {0x6A, 0x00, 0x00, 0x00}, {0x6B, 0x00, 0x00, 0x00}, /* 0x68 */
+  {0x6C, 0x00, 0x00, 0x00}, {0x6D, 0x00, 0x00, 0x00}, {0x6E, 0x00, 0x00, 0x00}, {0x6F, 0x00, 0x00, 0x00}, /* 0x6C */
+  {0x70, 0x00, 0x00, 0x00}, {0x71, 0x00, 0x00, 0x00}, {0x72, 0x00, 0x00, 0x00}, {0x73, 0x00, 0x00, 0x00}, /* 0x70 */
+  {0x74, 0x00, 0x00, 0x00}, {0x75, 0x00, 0x00, 0x00}, {0x76, 0x00, 0x00, 0x00}, {0x77, 0x00, 0x00, 0x00}, /* 0x74 */
+  {0x78, 0x00, 0x00, 0x00}, {0x79, 0x00, 0x00, 0x00}, {0x7A, 0x00, 0x00, 0x00}, {0x7B, 0x00, 0x00, 0x00}, /* 0x78 */
+  {0x7C, 0x00, 0x00, 0x00}, {0x7D, 0x00, 0x00, 0x00}, {0x7E, 0x00, 0x00, 0x00}, {0xE2, 0x8C, 0x82, 0x00}, /* 0x7C */
+  {0xC3, 0x87, 0x00, 0x00}, {0xC3, 0xBC, 0x00, 0x00}, {0xC3, 0xA9, 0x00, 0x00}, {0xC3, 0xA2, 0x00, 0x00}, /* 0x80 */
+  {0xC3, 0xA4, 0x00, 0x00}, {0xC3, 0xA0, 0x00, 0x00}, {0xC3, 0xA5, 0x00, 0x00}, {0xC3, 0xA7, 0x00, 0x00}, /* 0x84 */
+  {0xC3, 0xAA, 0x00, 0x00}, {0xC3, 0xAB, 0x00, 0x00}, {0xC3, 0xA8, 0x00, 0x00}, {0xC3, 0xAF, 0x00, 0x00}, /* 0x88 */
+  {0xC3, 0xAE, 0x00, 0x00}, {0xC3, 0xAC, 0x00, 0x00}, {0xC3, 0x84, 0x00, 0x00}, {0xC3, 0x85, 0x00, 0x00}, /* 0x8C */
+  {0xC3, 0x89, 0x00, 0x00}, {0xC3, 0xA6, 0x00, 0x00}, {0xC3, 0x86, 0x00, 0x00}, {0xC3, 0xB4, 0x00, 0x00}, /* 0x90 */
+  {0xC3, 0xB6, 0x00, 0x00}, {0xC3, 0xB2, 0x00, 0x00}, {0xC3, 0xBB, 0x00, 0x00}, {0xC3, 0xB9, 0x00, 0x00}, /* 0x94 */
+  {0xC3, 0xBF, 0x00, 0x00}, {0xC3, 0x96, 0x00, 0x00}, {0xC3, 0x9C, 0x00, 0x00}, {0xC2, 0xA2, 0x00, 0x00}, /* 0x98 */
+  {0xC2, 0xA3, 0x00, 0x00}, {0xC2, 0xA5, 0x00, 0x00}, {0xE2, 0x82, 0xA7, 0x00}, {0xC6, 0x92, 0x00, 0x00}, /* 0x9C */
+  {0xC3, 0xA1, 0x00, 0x00}, {0xC3, 0xAD, 0x00, 0x00}, {0xC3, 0xB3, 0x00, 0x00}, {0xC3, 0xBA, 0x00, 0x00}, /* 0xA0 */
+  {0xC3, 0xB1, 0x00, 0x00}, {0xC3, 0x91, 0x00, 0x00}, {0xC2, 0xAA, 0x00, 0x00}, {0xC2, 0xBA, 0x00, 0x00}, /* 0xA4 */
+  {0xC2, 0xBF, 0x00, 0x00}, {0xE2, 0x8C, 0x90, 0x00}, {0xC2, 0xAC, 0x00, 0x00}, {0xC2, 0xBD, 0x00, 0x00}, /* 0xA8 */
+  {0xC2, 0xBC, 0x00, 0x00}, {0xC2, 0xA1, 0x00, 0x00}, {0xC2, 0xAB, 0x00, 0x00}, {0xC2, 0xBB, 0x00, 0x00}, /* 0xAC */
+  {0xE2, 0x96, 0x91, 0x00}, {0xE2, 0x96, 0x92, 0x00}, {0xE2, 0x96, 0x93, 0x00}, {0xE2, 0x94, 0x82, 0x00}, /* 0xB0 */
+  {0xE2, 0x94, 0xA4, 0x00}, {0xE2, 0x95, 0xA1, 0x00}, {0xE2, 0x95, 0xA2, 0x00}, {0xE2, 0x95, 0x96, 0x00}, /* 0xB4 */
+  {0xE2, 0x95, 0x95, 0x00}, {0xE2, 0x95, 0xA3, 0x00}, {0xE2, 0x95, 0x91, 0x00}, {0xE2, 0x95, 0x97, 0x00}, /* 0xB8 */
+  {0xE2, 0x95, 0x9D, 0x00}, {0xE2, 0x95, 0x9C, 0x00}, {0xE2, 0x95, 0x9B, 0x00}, {0xE2, 0x94, 0x90, 0x00}, /* 0xBC */
+  {0xE2, 0x94, 0x94, 0x00}, {0xE2, 0x94, 0xB4, 0x00}, {0xE2, 0x94, 0xAC, 0x00}, {0xE2, 0x94, 0x9C, 0x00}, /* 0xC0 */
+  {0xE2, 0x94, 0x80, 0x00}, {0xE2, 0x94, 0xBC, 0x00}, {0xE2, 0x95, 0x9E, 0x00}, {0xE2, 0x95, 0x9F, 0x00}, /* 0xC4 */
+  {0xE2, 0x95, 0x9A, 0x00}, {0xE2, 0x95, 0x94, 0x00}, {0xE2, 0x95, 0xA9, 0x00}, {0xE2, 0x95, 0xA6, 0x00}, /* 0xC8 */
+  {0xE2, 0x95, 0xA0, 0x00}, {0xE2, 0x95, 0x90, 0x00}, {0xE2, 0x95, 0xAC, 0x00}, {0xE2, 0x95, 0xA7, 0x00}, /* 0xCC */
+  {0xE2, 0x95, 0xA8, 0x00}, {0xE2, 0x95, 0xA4, 0x00}, {0xE2, 0x95, 0xA5, 0x00}, {0xE2, 0x95, 0x99, 0x00}, /* 0xD0 */
+  {0xE2, 0x95, 0x98, 0x00}, {0xE2, 0x95, 0x92, 0x00}, {0xE2, 0x95, 0x93, 0x00}, {0xE2, 0x95, 0xAB, 0x00}, /* 0xD4 */
+  {0xE2, 0x95, 0xAA, 0x00}, {0xE2, 0x94, 0x98, 0x00}, {0xE2, 0x94, 0x8C, 0x00}, {0xE2, 0x96, 0x88, 0x00}, /* 0xD8 */
+  {0xE2, 0x96, 0x84, 0x00}, {0xE2, 0x96, 0x8C, 0x00}, {0xE2, 0x96, 0x90, 0x00}, {0xE2, 0x96, 0x80, 0x00}, /* 0xDC */
+  {0xCE, 0xB1, 0x00, 0x00}, {0xC3, 0x9F, 0x00, 0x00}, {0xCE, 0x93, 0x00, 0x00}, {0xCF, 0x80, 0x00, 0x00}, /* 0xE0 */
+  {0xCE, 0xA3, 0x00, 0x00}, {0xCF, 0x83, 0x00, 0x00}, {0xC2, 0xB5, 0x00, 0x00}, {0xCF, 0x84, 0x00, 0x00}, /* 0xE4 */
+  {0xCE, 0xA6, 0x00, 0x00}, {0xCE, 0x98, 0x00, 0x00}, {0xCE, 0xA9, 0x00, 0x00}, {0xCE, 0xB4, 0x00, 0x00}, /* 0xE8 */
+  {0xE2, 0x88, 0x9E, 0x00}, {0xCF, 0x86, 0x00, 0x00}, {0xCE, 0xB5, 0x00, 0x00}, {0xE2, 0x88, 0xA9, 0x00}, /* 0xEC */
+  {0xE2, 0x89, 0xA1, 0x00}, {0xC2, 0xB1, 0x00, 0x00}, {0xE2, 0x89, 0xA5, 0x00}, {0xE2, 0x89, 0xA4, 0x00}, /* 0xF0 */
+  {0xE2, 0x8C, 0xA0, 0x00}, {0xE2, 0x8C, 0xA1, 0x00}, {0xC3, 0xB7, 0x00, 0x00}, {0xE2, 0x89, 0x88, 0x00}, /* 0xF4 */
+  {0xC2, 0xB0, 0x00, 0x00}, {0xE2, 0x88, 0x99, 0x00}, {0xC2, 0xB7, 0x00, 0x00}, {0xE2, 0x88, 0x9A, 0x00}, /* 0xF8 */
+  {0xE2, 0x81, 0xBF, 0x00}, {0xC2, 0xB2, 0x00, 0x00}, {0xE2, 0x96, 0xA0, 0x00}, {0xC2, 0xA0, 0x00, 0x00} /* 0xFC */
+};
+
+const unsigned char cp437utf8len[256] = {
+  1, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 3,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 2, 2, 2, 2, 2,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 2, 3,
+  3, 2, 3, 3, 3, 3, 2, 3, 2, 3, 2, 3, 3, 2, 3, 2
+};
+
 cchar_t ToUTF(const int c)
 {
   /* save off attributes, then strip them off, convert, and finally put
@@ -30,3 +118,32 @@ cchar_t ToUTF(const int c)
   const cchar_t utfFull = utfRaw | attributes;
   return utfFull;
 }
+
+void ToUTFRow(wchar_t *dst, unsigned char const *src, const int len)
+{
+  int i;
+
+  /* straight table lookup; unlike ToUTF() there are no attribute bits to
+     strip, because rows are built from raw map symbols */
+  for (i = 0; i < len; ++i) dst[i] = (wchar_t)cp437utf[src[i]];
+  dst[len] = L'\0';
+}
+
+int ToUTF8Row(char *dst, unsigned char const *src, const int len)
+{
+  int i;
+  char *p = dst;
+
+  /* always copy the full padded 4-byte entry, then advance only by the real
+     sequence length, so that there is no branching on the encoded length
+     the copy can run at most one byte past the last sequence, which is why
+     UTF8_ROW_SIZE() reserves an extra byte */
+  for (i = 0; i < len; ++i)
+  {
+    memcpy(p, cp437utf8[src[i]], 4);
+    p += cp437utf8len[src[i]];
+  }
+  *p = '\0';
+
+  return (int)(p - dst);
+}
@@ -8,14 +8,39 @@
 #  include <pdcurses.h> /* MinGW32 etc. */
 # endif
 
+#include <wchar.h>
+
 /* wide character (16-bit UTF) equivalents for OEM extended ASCII / MS-DOS
    character set (8-bit code page 437)
    source: http://en.wikipedia.org/wiki/Code_page_437 */
 extern const cchar_t cp437utf[256];
 
+/* UTF-8 byte sequences for the same code points as cp437utf[], pre-encoded
+   so that byte-oriented output never has to do the encoding math
+   every entry is padded out to 4 bytes so it can be copied as a fixed-size
+   block; cp437utf8len[] holds the number of bytes that are actually used */
+extern const unsigned char cp437utf8[256][4];
+extern const unsigned char cp437utf8len[256];
+
+/* size of buffer needed by ToUTF8Row() for a row of len characters
+   (3 bytes max per character, plus room for the terminator) */
+#define UTF8_ROW_SIZE(len) (3 * (len) + 1)
+
 /* convert CP437 (IBM PC) character to PDCurses cchar_t wide character
    equivalent, preserving any attributes
    this is probably somewhat bogus, but doesn't seem to hurt anything */
 cchar_t ToUTF(const int c);
 
+/* convert a row of len raw CP437 characters (no attributes) to wide
+   characters in one pass
+   dst must have room for len + 1 entries, and will be null terminated */
+void ToUTFRow(wchar_t *dst, unsigned char const *src, const int len);
+
+/* convert a row of len raw CP437 characters (no attributes) to UTF-8 in one
+   pass
+   dst must have room for UTF8_ROW_SIZE(len) bytes, and will be null
+   terminated; returns the number of bytes written, not counting the
+   terminator */
+int ToUTF8Row(char *dst, unsigned char const *src, const int len);
+
 #endif
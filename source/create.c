@@ -113,7 +113,7 @@ int16 amount;
 static void get_all_stats ()
 {
   register player_type *p_ptr;
-  register race_type *r_ptr;
+  register race_type const *r_ptr;
   register int j;
 
   p_ptr = &py;
@@ -156,7 +156,7 @@ static void choose_race()
   char s;
   char tmp_str[80];
   register player_type *p_ptr;
-  register race_type *r_ptr;
+  register race_type const *r_ptr;
 
   j = 0;
   k = 0;
@@ -221,7 +221,7 @@ static void get_history()
   register int start_pos, end_pos, cur_len;
   int line_ctr, new_start, social_class;
   char history_block[240];
-  register background_type *b_ptr;
+  register background_type const *b_ptr;
 
   /* Get a block of history text				*/
   hist_ptr = py.misc.prace*3 + 1;
@@ -362,7 +362,7 @@ static void get_class()
   int cl[MAX_CLASS], exit_flag;
   register struct misc *m_ptr;
   register player_type *p_ptr;
-  class_type *c_ptr;
+  class_type const *c_ptr;
   char tmp_str[80], s;
   int32u mask;
 
@@ -35,10 +35,26 @@ char *strcpy();
 #include <strings.h>
 #endif
 
+/* Distance field for the "Monsters follow you around obstacles" option.
+   flow_dist[y][x] is one more than the number of steps from the player to
+   y, x, going round walls and rubble but through doors, or zero if it is
+   further than FLOW_RANGE or cannot be reached at all.  It is built by one
+   breadth first search, shared by every monster, and only rebuilt when the
+   player has moved or the walls have changed.  The search queue is kept
+   after a build, so that the next one need only clear the flow_len
+   squares it reached rather than the whole field.  */
+static int8u flow_dist[MAX_HEIGHT][MAX_WIDTH];
+static dcoord flow_qy[MAX_HEIGHT*MAX_WIDTH], flow_qx[MAX_HEIGHT*MAX_WIDTH];
+static int flow_y = -1, flow_x = -1, flow_len = 0;
+
 #if defined(LINT_ARGS)
 static int movement_rate(int16);
 static int check_mon_lite(int, int);
 static void get_moves(int, int *);
+static void flow_build(void);
+static void flow_moves(int, int *);
+static int breed_scan(int, int, int, int *);
+static int breed(int, int, int, int, int);
 static void make_attack(int);
 static void make_move(int, int *, int32u *);
 static void mon_cast_spell(int, int *);
@@ -56,13 +72,12 @@ void update_mon(monptr)
 int monptr;
 {
   register int flag;
-  register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
 #ifdef ATARIST_MWC
   int32u holder;
 #endif
 
+  PROF_ENTER(PROF_UPDATE_MON);
   m_ptr = &m_list[monptr];
   flag = false;
   if ((m_ptr->cdis <= MAX_SIGHT) &&
@@ -75,16 +90,15 @@ int monptr;
       /* Normal sight.	     */
       else if (los(char_row, char_col, (int)m_ptr->fy, (int)m_ptr->fx))
 	{
-	  c_ptr = &cave[m_ptr->fy][m_ptr->fx];
-	  r_ptr = &c_list[m_ptr->mptr];
-	  if (c_ptr->pl || c_ptr->tl ||
+	  if (cave_flag(cave_pl, m_ptr->fy, m_ptr->fx) ||
+	      cave_flag(cave_tl, m_ptr->fy, m_ptr->fx) ||
 	      (find_flag && m_ptr->cdis < 2 && player_light))
 	    {
 #ifdef ATARIST_MWC
 	      holder = CM_INVISIBLE;
-	      if ((holder & r_ptr->cmove) == 0)
+	      if ((holder & m_ptr->cmove) == 0)
 #else
-	      if ((CM_INVISIBLE & r_ptr->cmove) == 0)
+	      if ((CM_INVISIBLE & m_ptr->cmove) == 0)
 #endif
 		flag = true;
 	      else if (py.flags.see_inv)
@@ -100,7 +114,7 @@ int monptr;
 	  /* Infra vision.	 */
 	  else if ((py.flags.see_infra > 0) &&
 		   (m_ptr->cdis <= py.flags.see_infra) &&
-		   (CD_INFRA & r_ptr->cdefense))
+		   (CD_INFRA & m_ptr->cdefense))
 	    {
 	      flag = true;
 	      c_recall[m_ptr->mptr].r_cdefense |= CD_INFRA;
@@ -125,6 +139,7 @@ int monptr;
       lite_spot((int)m_ptr->fy, (int)m_ptr->fx);
       screen_change = true; /* notify inven_command */
     }
+  PROF_LEAVE(PROF_UPDATE_MON);
 }
 
 
@@ -339,6 +354,108 @@ register int *mm;
 }
 
 
+/* Forget the flow field, because the walls have changed	*/
+void flow_reset()
+{
+  flow_y = -1;
+  flow_x = -1;
+}
+
+
+/* Build the flow field outward from the player			*/
+static void flow_build()
+{
+  register int i, head, tail;
+  register cave_type *c_ptr;
+  int y, x, d;
+
+  for (i = 0; i < flow_len; i++)
+    flow_dist[flow_qy[i]][flow_qx[i]] = 0;
+  flow_y = char_row;
+  flow_x = char_col;
+  flow_dist[flow_y][flow_x] = 1;
+  flow_qy[0] = flow_y;
+  flow_qx[0] = flow_x;
+  head = 0;
+  tail = 1;
+  while (head < tail)
+    {
+      d = flow_dist[flow_qy[head]][flow_qx[head]];
+      if (d > FLOW_RANGE)
+	break;
+      for (i = 1; i <= 9; i++)
+	{
+	  y = flow_qy[head];
+	  x = flow_qx[head];
+	  if (i == 5 || !mmove(i, &y, &x) || flow_dist[y][x] != 0)
+	    continue;
+	  c_ptr = &cave[y][x];
+	  if ((c_ptr->fval <= MAX_OPEN_SPACE) ||
+	      ((c_ptr->tptr != 0) &&
+	       ((t_list[c_ptr->tptr].tval == TV_CLOSED_DOOR) ||
+		(t_list[c_ptr->tptr].tval == TV_SECRET_DOOR))))
+	    {
+	      flow_dist[y][x] = d + 1;
+	      flow_qy[tail] = y;
+	      flow_qx[tail] = x;
+	      tail++;
+	    }
+	}
+      head++;
+    }
+  flow_len = tail;
+}
+
+
+/* Reorder the directions get_moves() picked so that those which lead
+   closer to the player along the flow field come first, keeping
+   get_moves()' order among equally good ones.			*/
+static void flow_moves(monptr, mm)
+int monptr;
+register int *mm;
+{
+  register int i, j, k;
+  int y, x, dir[8], dis[8];
+  register monster_type *m_ptr;
+
+  m_ptr = &m_list[monptr];
+  if ((flow_y != char_row) || (flow_x != char_col))
+    flow_build();
+  /* out of range, or next to the player, where get_moves() does fine */
+  if (flow_dist[m_ptr->fy][m_ptr->fx] <= 2)
+    return;
+
+  /* the directions get_moves() picked, then the rest */
+  for (k = 0; k < 5; k++)
+    dir[k] = mm[k];
+  for (i = 1; i <= 9; i++)
+    {
+      for (j = 0; j < k; j++)
+	if (dir[j] == i)
+	  break;
+      if (i != 5 && j == k && k < 8)
+	dir[k++] = i;
+    }
+  for (i = 0; i < k; i++)
+    {
+      y = m_ptr->fy;
+      x = m_ptr->fx;
+      if (mmove(dir[i], &y, &x) && flow_dist[y][x] != 0)
+	dis[i] = flow_dist[y][x];
+      else
+	dis[i] = MAX_UCHAR + 1;
+      /* insertion sort, stable, so ties keep get_moves()' order */
+      for (j = i; j > 0 && dis[j-1] > dis[j]; j--)
+	{
+	  y = dis[j]; dis[j] = dis[j-1]; dis[j-1] = y;
+	  x = dir[j]; dir[j] = dir[j-1]; dir[j-1] = x;
+	}
+    }
+  for (i = 0; i < 5; i++)
+    mm[i] = dir[i];
+}
+
+
 /* Make an attack on the player (chuckle.)		-RAK-	*/
 static void make_attack(monptr)
 int monptr;
@@ -346,9 +463,9 @@ int monptr;
   int attype, adesc, adice, asides;
   int i, j, damage, flag, attackn, notice, visible;
   int32 gold;
-  int8u *attstr;
+  int8u const *attstr;
   vtype cdesc, tmp_str, ddesc;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   monster_type *m_ptr;
   register struct misc *p_ptr;
   register struct flags *f_ptr;
@@ -953,7 +1070,7 @@ int32u *rcmove;
   do_turn = false;
   do_move = false;
   m_ptr = &m_list[monptr];
-  movebits = c_list[m_ptr->mptr].cmove;
+  movebits = m_ptr->cmove;
   do
     {
       /* Get new position		*/
@@ -1058,7 +1175,7 @@ int32u *rcmove;
 	      (t_list[c_ptr->tptr].tval == TV_VIS_TRAP) &&
 	      (t_list[c_ptr->tptr].subval == 99))
 	    {
-	      if (randint(OBJ_RUNE_PROT) < c_list[m_ptr->mptr].level)
+	      if (randint(OBJ_RUNE_PROT) < m_ptr->level)
 		{
 		  if ((newy==char_row) && (newx==char_col))
 		    msg_print("The rune of protection is broken!");
@@ -1175,7 +1292,7 @@ int *took_turn;
   int spell_choice[30];
   vtype cdesc, outval, ddesc;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
 #ifdef ATARIST_MWC
   int32u holder;
 #endif
@@ -1402,79 +1519,95 @@ int *took_turn;
 }
 
 
-/* Places creature adjacent to given location		-RAK-	*/
-/* Rats and Flys are fun!					 */
-int multiply_monster(y, x, cr_index, monptr)
+/* Look round a breeder of race cr_index at y, x, in one pass.  Returns
+   how many of the nine squares hold monsters, counting the breeder, and
+   sets *room to the squares next to it that a child could be put on, as
+   bit (dy+1)*3 + (dx+1) for the square at y+dy, x+dx.		*/
+static int breed_scan(y, x, cr_index, room)
 int y, x, cr_index;
-int monptr;
+int *room;
 {
-  register int i, j, k;
+  register int i, j;
   register cave_type *c_ptr;
-  int result;
+  int crowd;
 #ifdef ATARIST_MWC
   int32u holder;
 #endif
 
+  crowd = 0;
+  *room = 0;
+  for (i = y-1; i <= y+1; i++)
+    for (j = x-1; j <= x+1; j++)
+      if (in_bounds(i, j))
+	{
+	  c_ptr = &cave[i][j];
+	  if (c_ptr->cptr > 1)
+	    crowd++;
+	  /* don't create a new creature on top of the old one, that causes
+	     invincible/invisible creatures to appear */
+	  if ((i == y && j == x) || (c_ptr->fval > MAX_OPEN_SPACE) ||
+	      (c_ptr->tptr != 0) || (c_ptr->cptr == 1))
+	    continue;
+	  /* Some critters are cannibalistic!	    */
+	  if ((c_ptr->cptr == 0) ||
+#ifdef ATARIST_MWC
+	      ((c_list[cr_index].cmove & (holder = CM_EATS_OTHER))
+#else
+	      ((c_list[cr_index].cmove & CM_EATS_OTHER)
+#endif
+	       /* Check the experience level -CJS- */
+	       && c_list[cr_index].mexp >=
+	       c_list[m_list[c_ptr->cptr].mptr].mexp))
+	    *room |= 1 << ((i-y+1)*3 + (j-x+1));
+	}
+  return(crowd);
+}
+
+
+/* Try to place a child of race cr_index next to y, x, on one of the
+   squares in room, as found by breed_scan().  Makes the same random tries
+   as ever, but tests them against room instead of the cave.	*/
+static int breed(y, x, cr_index, monptr, room)
+int y, x, cr_index;
+int monptr, room;
+{
+  register int i, j, k;
+  register cave_type *c_ptr;
+  int result;
+
+  /* nowhere to put it, so every try would fail */
+  if (room == 0)
+    return false;
   i = 0;
   do
     {
-      j = y - 2 + randint(3);
-      k = x - 2 + randint(3);
-      /* don't create a new creature on top of the old one, that causes
-	 invincible/invisible creatures to appear */
-      if (in_bounds(j, k) && (j != y || k != x))
+      j = randint(3) - 2;
+      k = randint(3) - 2;
+      if (room & (1 << ((j+1)*3 + (k+1))))
 	{
+	  j += y;
+	  k += x;
 	  c_ptr = &cave[j][k];
-	  if ((c_ptr->fval <= MAX_OPEN_SPACE) && (c_ptr->tptr == 0) &&
-	      (c_ptr->cptr != 1))
+	  if (c_ptr->cptr > 1)     /* Eat the creature there already */
 	    {
-	      if (c_ptr->cptr > 1)     /* Creature there already?	*/
-		{
-		  /* Some critters are cannibalistic!	    */
-#ifdef ATARIST_MWC
-		  holder = CM_EATS_OTHER;
-		  if ((c_list[cr_index].cmove & holder)
-#else
-		  if ((c_list[cr_index].cmove & CM_EATS_OTHER)
-#endif
-		      /* Check the experience level -CJS- */
-		     && c_list[cr_index].mexp >=
-		      c_list[m_list[c_ptr->cptr].mptr].mexp)
-		    {
-		      /* It ate an already processed monster.Handle normally.*/
-		      if (monptr < c_ptr->cptr)
-			delete_monster((int) c_ptr->cptr);
-		      /* If it eats this monster, an already processed mosnter
-			 will take its place, causing all kinds of havoc.
-			 Delay the kill a bit. */
-		      else
-			fix1_delete_monster((int) c_ptr->cptr);
-
-		      /* in case compact_monster() is called,it needs monptr */
-		      hack_monptr = monptr;
-		      /* Place_monster() may fail if monster list full.  */
-		      result = place_monster(j, k, cr_index, false);
-		      hack_monptr = -1;
-		      if (! result)
-			return false;
-		      mon_tot_mult++;
-		      return check_mon_lite(j, k);
-		    }
-		}
+	      /* It ate an already processed monster.Handle normally.*/
+	      if (monptr < c_ptr->cptr)
+		delete_monster((int) c_ptr->cptr);
+	      /* If it eats this monster, an already processed mosnter
+		 will take its place, causing all kinds of havoc.
+		 Delay the kill a bit. */
 	      else
-		/* All clear,  place a monster	  */
-		{
-		  /* in case compact_monster() is called,it needs monptr */
-		  hack_monptr = monptr;
-		  /* Place_monster() may fail if monster list full.  */
-		  result = place_monster(j, k, cr_index, false);
-		  hack_monptr = -1;
-		  if (! result)
-		    return false;
-		  mon_tot_mult++;
-		  return check_mon_lite(j, k);
-		}
+		fix1_delete_monster((int) c_ptr->cptr);
 	    }
+	  /* in case compact_monster() is called,it needs monptr */
+	  hack_monptr = monptr;
+	  /* Place_monster() may fail if monster list full.  */
+	  result = place_monster(j, k, cr_index, false);
+	  hack_monptr = -1;
+	  if (! result)
+	    return false;
+	  mon_tot_mult++;
+	  return check_mon_lite(j, k);
 	}
       i++;
     }
@@ -1483,18 +1616,31 @@ int monptr;
 }
 
 
+/* Places creature adjacent to given location		-RAK-	*/
+/* Rats and Flys are fun!					 */
+int multiply_monster(y, x, cr_index, monptr)
+int y, x, cr_index;
+int monptr;
+{
+  int room;
+
+  (void) breed_scan(y, x, cr_index, &room);
+  return breed(y, x, cr_index, monptr, room);
+}
+
+
 /* Move the critters about the dungeon			-RAK-	*/
 static void mon_move(monptr, rcmove)
 int monptr;
 int32u *rcmove;
 {
   register int i, j;
-  int k, move_test, dir;
+  int k, move_test, dir, room;
 #ifdef M_XENIX
   /* Avoid 'register' bug.  */
-  creature_type *r_ptr;
+  creature_type const *r_ptr;
 #else
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
 #endif
   register monster_type *m_ptr;
   int mm[9];
@@ -1510,24 +1656,21 @@ int32u *rcmove;
   rest_val = abs (py.flags.rest);
 #ifdef ATARIST_MWC
   holder = CM_MULTIPLY;
-  if ((r_ptr->cmove & holder) && (MAX_MON_MULT >= mon_tot_mult) &&
+  if ((m_ptr->cmove & holder) && (MAX_MON_MULT >= mon_tot_mult) &&
 #else
-  if ((r_ptr->cmove & CM_MULTIPLY) && (MAX_MON_MULT >= mon_tot_mult) &&
+  if ((m_ptr->cmove & CM_MULTIPLY) && (MAX_MON_MULT >= mon_tot_mult) &&
 #endif
       ((rest_val % MON_MULT_ADJ) == 0))
     {
-      k = 0;
-      for (i = m_ptr->fy-1; i <= m_ptr->fy+1; i++)
-	for (j = m_ptr->fx-1; j <= m_ptr->fx+1; j++)
-	  if (in_bounds(i, j) && (cave[i][j].cptr > 1))
-	    k++;
+      k = breed_scan((int)m_ptr->fy, (int)m_ptr->fx, (int)m_ptr->mptr,
+		     &room);
       /* can't call randint with a value of zero, increment counter
 	 to allow creature multiplication */
       if (k == 0)
 	k++;
       if ((k < 4) && (randint(k*MON_MULT_ADJ) == 1))
-	if (multiply_monster((int)m_ptr->fy, (int)m_ptr->fx,
-			 (int)m_ptr->mptr, monptr))
+	if (breed((int)m_ptr->fy, (int)m_ptr->fx, (int)m_ptr->mptr, monptr,
+		  room))
 #ifdef ATARIST_MWC
 	  *rcmove |= holder;
 #else
@@ -1539,9 +1682,9 @@ int32u *rcmove;
   /* if in wall, must immediately escape to a clear area */
 #ifdef ATARIST_MWC
   holder = CM_PHASE;
-  if (!(r_ptr->cmove & holder) &&
+  if (!(m_ptr->cmove & holder) &&
 #else
-  if (!(r_ptr->cmove & CM_PHASE) &&
+  if (!(m_ptr->cmove & CM_PHASE) &&
 #endif
       (cave[m_ptr->fy][m_ptr->fx].fval >= MIN_CAVE_WALL))
     {
@@ -1601,7 +1744,7 @@ int32u *rcmove;
   /* Creature is confused or undead turned? */
   else if (m_ptr->confused)
     {
-      if (r_ptr->cdefense & CD_UNDEAD) /* Undead only get confused from
+      if (m_ptr->cdefense & CD_UNDEAD) /* Undead only get confused from
 					  turn undead, so they should flee */
 	{
 	  get_moves(monptr,mm);
@@ -1620,7 +1763,7 @@ int32u *rcmove;
 	  mm[4] = randint(9);
 	}
       /* don't move him if he is not supposed to move! */
-      if (!(r_ptr->cmove & CM_ATTACK_ONLY))
+      if (!(m_ptr->cmove & CM_ATTACK_ONLY))
 	make_move(monptr, mm, rcmove);
       m_ptr->confused--;
       move_test = true;
@@ -1635,7 +1778,7 @@ int32u *rcmove;
   if (!move_test)
     {
       /* 75% random movement */
-      if ((r_ptr->cmove & CM_75_RANDOM) && (randint(100) < 75))
+      if ((m_ptr->cmove & CM_75_RANDOM) && (randint(100) < 75))
 	{
 	  mm[0] = randint(9);
 	  mm[1] = randint(9);
@@ -1646,7 +1789,7 @@ int32u *rcmove;
 	  make_move(monptr, mm, rcmove);
 	}
       /* 40% random movement */
-      else if ((r_ptr->cmove & CM_40_RANDOM) && (randint(100) < 40))
+      else if ((m_ptr->cmove & CM_40_RANDOM) && (randint(100) < 40))
 	{
 	  mm[0] = randint(9);
 	  mm[1] = randint(9);
@@ -1657,7 +1800,7 @@ int32u *rcmove;
 	  make_move(monptr, mm, rcmove);
 	}
       /* 20% random movement */
-      else if ((r_ptr->cmove & CM_20_RANDOM) && (randint(100) < 20))
+      else if ((m_ptr->cmove & CM_20_RANDOM) && (randint(100) < 20))
 	{
 	  mm[0] = randint(9);
 	  mm[1] = randint(9);
@@ -1668,7 +1811,7 @@ int32u *rcmove;
 	  make_move(monptr, mm, rcmove);
 	}
       /* Normal movement */
-      else if (r_ptr->cmove & CM_MOVE_NORMAL)
+      else if (m_ptr->cmove & CM_MOVE_NORMAL)
 	{
 	  if (randint(200) == 1)
 	    {
@@ -1679,12 +1822,16 @@ int32u *rcmove;
 	      mm[4] = randint(9);
 	    }
 	  else
-	    get_moves(monptr, mm);
+	    {
+	      get_moves(monptr, mm);
+	      if (smart_path_flag && !(m_ptr->cmove & CM_PHASE))
+		flow_moves(monptr, mm);
+	    }
 	  *rcmove |= CM_MOVE_NORMAL;
 	  make_move(monptr, mm, rcmove);
 	}
       /* Attack, but don't move */
-      else if (r_ptr->cmove & CM_ATTACK_ONLY)
+      else if (m_ptr->cmove & CM_ATTACK_ONLY)
 	{
 	  if (m_ptr->cdis < 2)
 	    {
@@ -1696,7 +1843,7 @@ int32u *rcmove;
 	       moved, but didn't.  */
 	    *rcmove |= CM_ATTACK_ONLY;
 	}
-      else if ((r_ptr->cmove & CM_ONLY_MAGIC) && (m_ptr->cdis < 2))
+      else if ((m_ptr->cmove & CM_ONLY_MAGIC) && (m_ptr->cdis < 2))
 	{
 	  /* A little hack for Quylthulgs, so that one will eventually notice
 	     that they have no physical attacks.  */
@@ -1725,6 +1872,7 @@ int attack;
   int32u holder;
 #endif
 
+  PROF_ENTER(PROF_CREATURES);
   /* Process the monsters  */
   for (i = mfptr - 1; i >= MIN_MONIX && !death; i--)
     {
@@ -1752,13 +1900,13 @@ int attack;
 		wake = false;
 		ignore = false;
 		rcmove = 0;
-		if (m_ptr->ml || (m_ptr->cdis <= c_list[m_ptr->mptr].aaf)
+		if (m_ptr->ml || (m_ptr->cdis <= m_ptr->aaf)
 		    /* Monsters trapped in rock must be given a turn also,
 		       so that they will die/dig out immediately.  */
 #ifdef ATARIST_MWC
-		    || ((! (c_list[m_ptr->mptr].cmove & (holder = CM_PHASE)))
+		    || ((! (m_ptr->cmove & (holder = CM_PHASE)))
 #else
-		    || ((! (c_list[m_ptr->mptr].cmove & CM_PHASE))
+		    || ((! (m_ptr->cmove & CM_PHASE))
 #endif
 			&& cave[m_ptr->fy][m_ptr->fx].fval >= MIN_CAVE_WALL))
 		  {
@@ -1786,8 +1934,7 @@ int attack;
 		      {
 			/* NOTE: Balrog = 100*100 = 10000, it always
 			   recovers instantly */
-			if (randint(5000) < c_list[m_ptr->mptr].level
-			    * c_list[m_ptr->mptr].level)
+			if (randint(5000) < m_ptr->level * m_ptr->level)
 			  m_ptr->stunned = 0;
 			else
 			  m_ptr->stunned--;
@@ -1837,4 +1984,5 @@ int attack;
 	}
     }
   /* End processing monsters	   */
+  PROF_LEAVE(PROF_CREATURES);
 }
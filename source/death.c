@@ -653,11 +653,17 @@ void exit_game()
      inhibits the printing of the tomb. */
   if (turn >= 0)
   {
+    event_log(EV_DEATH, died_from, py.misc.max_exp);
     if (total_winner) kingly();
     print_tomb();
   }
   /* Save the memory at least. */
   if (character_generated && !character_saved) save_char();
+  /* the crash recovery journal is only kept if the save failed */
+  journal_close();
+#ifdef PROFILE
+  prof_dump();
+#endif
   /* add score to scorefile if applicable */
   if (character_generated)
   {
@@ -33,6 +33,19 @@ static void unsample();
 
 char titles[MAX_TITLES][10];
 
+/* The last description inven_objdes() made for each inventory slot, with
+   the item it described and what was then known about that kind of item
+   (the object_ident[] entry, 0 if there is none).  Anything that changes
+   the description, identifying the item or its kind, trying it,
+   inscribing it or changing the size of the stack, changes one or the
+   other, so a stale description is never used.  */
+static struct inven_desc_type
+{
+  inven_type item;
+  int8u kind;
+  bigvtype desc;
+} inven_descs[INVEN_ARRAY_SIZE];
+
 /* Object descriptor routines					*/
 
 int is_a_vowel(ch)
@@ -57,6 +70,16 @@ void magic_init()
 
   set_seed(randes_seed);
 
+#ifndef MACGAME
+  /* Shuffle copies of the names, so the tables themselves stay read-only */
+  (void) memcpy(colors, color_names, sizeof(colors));
+  (void) memcpy(mushrooms, mushroom_names, sizeof(mushrooms));
+  (void) memcpy(woods, wood_names, sizeof(woods));
+  (void) memcpy(metals, metal_names, sizeof(metals));
+  (void) memcpy(rocks, rock_names, sizeof(rocks));
+  (void) memcpy(amulets, amulet_names, sizeof(amulets));
+#endif
+
   /* The first 3 entries for colors are fixed, (slime & apple juice, water) */
   for (i = 3; i < MAX_COLORS; i++)
     {
@@ -118,6 +141,9 @@ void magic_init()
       (void) strcpy(titles[h], string);
     }
   reset_seed();
+  /* the flavors may have changed under any remembered descriptions */
+  for (i = 0; i < INVEN_ARRAY_SIZE; i++)
+    inven_descs[i].desc[0] = '\0';
 }
 
 int16 object_offset(t_ptr)
@@ -254,6 +280,7 @@ int *item;
   register int i, x1, x2;
   int j;
   register inven_type *i_ptr, *t_ptr;
+  bigvtype tmp_str;
 #ifdef ATARIST_MWC
   int32u holder;
 #endif
@@ -270,6 +297,11 @@ int *item;
   if (!known1_p(i_ptr))
     {
       known1(i_ptr);
+      if (event_active())
+	{
+	  objdes(tmp_str, i_ptr, true);
+	  event_log(EV_IDENTIFY, tmp_str, (int32)i_ptr->number);
+	}
       x1 = i_ptr->tval;
       x2 = i_ptr->subval;
       if (x2 < ITEM_SINGLE_STACK_MIN || x2 >= ITEM_GROUP_MIN)
@@ -685,7 +717,7 @@ void invcopy(to, from_index)
 register inven_type *to;
 int from_index;
 {
-  register treasure_type *from;
+  register treasure_type const *from;
 
   from = &object_list[from_index];
   to->index	= from_index;
@@ -695,7 +727,7 @@ int from_index;
   to->tval      = from->tval;
   to->tchar     = from->tchar;
   to->p1        = from->p1;
-  to->cost	= from->cost;
+  to->cost	= object_cost(from_index);
   to->subval    = from->subval;
   to->number    = from->number;
   to->weight    = from->weight;
@@ -710,6 +742,37 @@ int from_index;
 }
 
 
+/* Describe inventory[item] exactly as objdes(out_val, &inventory[item],
+   true) does, but only build the description again when the item or what
+   is known about its kind has changed since this slot was last described.
+   The inventory screens redraw every line after each command.  */
+void inven_objdes(out_val, item)
+char *out_val;
+int item;
+{
+  register inven_type *i_ptr;
+  register struct inven_desc_type *d_ptr;
+  int16 offset;
+  int8u kind;
+
+  i_ptr = &inventory[item];
+  d_ptr = &inven_descs[item];
+  if ((offset = object_offset(i_ptr)) < 0)
+    kind = 0;
+  else
+    kind = object_ident[(offset << 6)
+			+ (i_ptr->subval & (ITEM_SINGLE_STACK_MIN - 1))];
+  if (d_ptr->desc[0] == '\0' || d_ptr->kind != kind
+      || memcmp((char *)&d_ptr->item, (char *)i_ptr, sizeof(inven_type)))
+    {
+      objdes(d_ptr->desc, i_ptr, true);
+      d_ptr->item = *i_ptr;
+      d_ptr->kind = kind;
+    }
+  (void) strcpy(out_val, d_ptr->desc);
+}
+
+
 /* Describe number of remaining charges.		-RAK-	*/
 void desc_charges(item_val)
 int item_val;
@@ -138,7 +138,7 @@ void dungeon()
 #ifndef MAC
       /* The Mac ignores the game hours file		*/
       /* Check for game hours			       */
-      if (((turn % 250) == 1) && !check_time())
+      if (((turn % 250) == 1) && journal_event(JE_CLOSING, !check_time()))
 	if (closing_flag > 4)
 	  {
 	    msg_print("The gates to Moria are now closed.");
@@ -161,7 +161,7 @@ void dungeon()
 
       /* turn over the store contents every, say, 1000 turns */
       if ((dun_level != 0) && ((turn % 1000) == 0))
-	store_maint();
+	store_turnover();
 
       /* Check for creature generation		*/
       if (randint(MAX_MALLOC_CHANCE) == 1)
@@ -522,20 +522,25 @@ void dungeon()
 	if (macgetkey(CNIL, true))
 	  disturb(0, 0);
 #else
+      /* When recovering from the journal, the keyboard is not looked at,
+	 the journal says whether there was an interruption instead. */
       if ((command_count > 0 || find_flag || f_ptr->rest != 0)
+	  && journal_event(JE_INTERRUPT, !journal_replaying()
 #if defined(MSDOS) || defined(VMS)
 	  && kbhit()
 #else
 	  && (check_input (find_flag ? 0 : 10000))
 #endif
-	  )
+	  ))
 	{
 #ifdef MSDOS
-	  (void) msdos_getch();
+	  if (kbhit())
+	    (void) msdos_getch();
 #endif
 #ifdef VMS
 	  /* Get and ignore the key used to interrupt resting/running.  */
-	  (void) vms_getch ();
+	  if (kbhit())
+	    (void) vms_getch ();
 #endif
 	  disturb (0, 0);
 	}
@@ -910,6 +915,7 @@ void dungeon()
 		  else
 		    {
 		      msg_flag = false;
+		      journal_command();
 #ifdef MAC
 		      unloadsegments();
 		      enablesavecmd(true);
@@ -1233,6 +1239,7 @@ char com_val;
     case CTRL('G'):	/*^G = treasure*/
     case '@':
     case '+':
+    case '%':
       break;
     case CTRL('U'):	/*^U = summon  */
       com_val = '&';
@@ -1249,7 +1256,7 @@ static void do_command(com_val)
 char com_val;
 {
   int dir_val, do_pickup;
-  int y, x, i, j;
+  int y, x, i;
   vtype out_val, tmp_str;
   register struct flags *f_ptr;
 
@@ -1296,37 +1303,23 @@ char com_val;
       if (command_count > 0)
 	{
 	  i = command_count;
-	  if (i > MAX_SAVE_MSG)
-	    i = MAX_SAVE_MSG;
 	  command_count = 0;
 	}
       else if (last_command != CTRL('P'))
 	i = 1;
       else
-	i = MAX_SAVE_MSG;
-      j = last_msg;
-      if (i > 1)
-	{
-	  save_screen();
-	  x = i;
-	  while (i > 0)
-	    {
-	      i--;
-	      prt(old_msg[j], i, 0);
-	      if (j == 0)
-		j = MAX_SAVE_MSG-1;
-	      else
-		j--;
-	    }
-	  erase_line (x, 0);
-	  pause_line(x);
-	  restore_screen();
-	}
+	i = 0;
+      if (msglog_size() == 0)
+	;
+      else if (i != 1)
+	/* page through the whole message history */
+	msglog_browse((int32u)i);
       else
 	{
 	  /* Distinguish real and recovered messages with a '>'. -CJS- */
 	  put_buffer(">", 0, 0);
-	  prt(old_msg[j], 0, 1);
+	  msglog_line(0, out_val);
+	  prt(out_val, 0, 1);
 	}
       free_turn_flag = true;
       break;
@@ -1530,13 +1523,13 @@ char com_val;
 // section. The direction calculation is not intuitive. Sorry.
 */
 	      for(;;){
-		x += ((dir_val-1)%3 - 1) * SCREEN_WIDTH/2;
-		y -= ((dir_val-1)/3 - 1) * SCREEN_HEIGHT/2;
+		x += ((dir_val-1)%3 - 1) * view_width/2;
+		y -= ((dir_val-1)/3 - 1) * view_height/2;
 		if (x < 0 || y < 0 || x >= cur_width || y >= cur_width)
 		  {
 		    msg_print("You've gone past the end of your map.");
-		    x -= ((dir_val-1)%3 - 1) * SCREEN_WIDTH/2;
-		    y += ((dir_val-1)/3 - 1) * SCREEN_HEIGHT/2;
+		    x -= ((dir_val-1)%3 - 1) * view_width/2;
+		    y += ((dir_val-1)/3 - 1) * view_height/2;
 		    break;
 		  }
 		if (get_panel(y, x, true))
@@ -1764,6 +1757,9 @@ char com_val;
 	    case '@':
 	      wizard_create();
 	      break;
+	    case '%':	/*% = profiling counters */
+	      wizard_profile();
+	      break;
 	    default:
 	      if (rogue_like_commands)
 		prt("Type '?' or '\\' for help.", 0, 0);
@@ -1990,7 +1986,7 @@ static void examine_book()
   int i, k, item_val, flag;
   int spell_index[31];
   register inven_type *i_ptr;
-  register spell_type *s_ptr;
+  register spell_type const *s_ptr;
 
   if (!find_range(TV_MAGIC_BOOK, TV_PRAYER_BOOK, &i, &k))
     msg_print("You are not carrying any books.");
@@ -0,0 +1,299 @@
+/* source/events.c: gameplay event stream
+
+   When the MORIA_EVENTS environment variable names a file, notable things
+   that happen in the game (kills, damage taken, level changes, items picked
+   up, identified and bought, and the character's death) are appended to it
+   as JSON lines, one object per event, e.g.
+
+     {"time":1700000000,"turn":1234,"depth":5,"event":"kill",
+      "what":"Cave spider","value":1}
+
+   with "what" and "value" depending on the event, see event_log().
+
+   As with the session recorder, the game never waits on the disk.  Events
+   are formatted into an in-memory ring buffer and a background thread
+   drains the ring to the file; the lock is only held long enough to read or
+   update the ring indices.  If the writer ever falls so far behind that an
+   event does not fit, the event is dropped, and a "dropped" event giving
+   the number lost is written as soon as there is room again.
+
+   Nothing is logged while the crash recovery journal is being replayed,
+   since those events were already logged before the crash. */
+
+#include "config.h"
+#include "externs.h"
+
+#if defined(_MSC_VER) || defined(__MINGW32__) /* Windows */
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+#else
+# include <pthread.h>
+#endif
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define EV_RING_SIZE (64L * 1024L)
+/* longest line ev_format() can produce, with every character of a
+   bigvtype name escaped */
+#define EV_LINE_MAX  (6 * sizeof(bigvtype) + 128)
+
+static char const *const ev_names[EV_MAX] = {
+  "kill", "damage", "level", "pickup", "identify", "purchase", "death"
+};
+
+static FILE *ev_fp = NULL;
+static char ev_ring[EV_RING_SIZE];
+/* stream offsets, only ever compared by difference, so they may wrap;
+   ev_head is advanced by the game, ev_tail by the writer thread */
+static int32u ev_head, ev_tail;
+static bool ev_done;
+/* events lost to a full ring since the last one that fit */
+static int32u ev_dropped;
+/* set while event_log() runs; a signal handler that ends the game from
+   inside it must not wait for ev_lock, which may be held */
+static volatile sig_atomic_t ev_busy = 0;
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+static CRITICAL_SECTION ev_lock;
+static HANDLE ev_wake, ev_thread;
+# define EV_LOCK()   EnterCriticalSection(&ev_lock)
+# define EV_UNLOCK() LeaveCriticalSection(&ev_lock)
+#else
+static pthread_mutex_t ev_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ev_wake = PTHREAD_COND_INITIALIZER;
+static pthread_t ev_thread;
+# define EV_LOCK()   (void) pthread_mutex_lock(&ev_lock)
+# define EV_UNLOCK() (void) pthread_mutex_unlock(&ev_lock)
+#endif
+
+/* Copy len bytes to the ring at stream offset pos, wrapping as needed */
+static void ev_copy_in(const int32u pos, char const *buf, const int32u len)
+{
+  int32u off = pos % EV_RING_SIZE;
+  int32u n = EV_RING_SIZE - off;
+
+  if (n > len) n = len;
+  memcpy(&ev_ring[off], buf, n);
+  if (n < len) memcpy(ev_ring, buf + n, len - n);
+}
+
+/* Write the ring contents between stream offsets from and to to the file */
+static void ev_drain(const int32u from, const int32u to)
+{
+  int32u off = from % EV_RING_SIZE;
+  int32u len = to - from;
+  int32u n = EV_RING_SIZE - off;
+
+  if (n > len) n = len;
+  (void) fwrite(&ev_ring[off], 1, n, ev_fp);
+  if (n < len) (void) fwrite(ev_ring, 1, len - n, ev_fp);
+  (void) fflush(ev_fp);
+}
+
+/* Wait until there is something to write, then write it; returns false
+   once the game is over and everything has been written */
+static bool ev_writer_step()
+{
+  int32u head, tail;
+  bool done;
+
+  EV_LOCK();
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  while (ev_head == ev_tail && !ev_done)
+  {
+    EV_UNLOCK();
+    (void) WaitForSingleObject(ev_wake, INFINITE);
+    EV_LOCK();
+  }
+#else
+  while (ev_head == ev_tail && !ev_done)
+    (void) pthread_cond_wait(&ev_wake, &ev_lock);
+#endif
+  head = ev_head;
+  tail = ev_tail;
+  done = ev_done;
+  EV_UNLOCK();
+
+  if (head == tail) return !done;
+  ev_drain(tail, head);
+  EV_LOCK();
+  ev_tail = head;
+  EV_UNLOCK();
+  return true;
+}
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+static DWORD WINAPI ev_writer(LPVOID arg)
+#else
+static void *ev_writer(void *arg)
+#endif
+{
+  (void) arg;
+  while (ev_writer_step())
+    ;
+  return 0;
+}
+
+static void ev_signal()
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  (void) SetEvent(ev_wake);
+#else
+  (void) pthread_cond_signal(&ev_wake);
+#endif
+}
+
+/* Copies s to buf as a JSON string, quotes included, returning the end */
+static char *ev_quote(char *buf, char const *s)
+{
+  *buf++ = '"';
+  for (; *s != '\0'; s++)
+  {
+    if (*s == '"' || *s == '\\')
+    {
+      *buf++ = '\\';
+      *buf++ = *s;
+    }
+    else if ((unsigned char)*s < ' ')
+    {
+      (void) sprintf(buf, "\\u%04x", (unsigned char)*s);
+      buf += 6;
+    }
+    else
+      *buf++ = *s;
+  }
+  *buf++ = '"';
+  return buf;
+}
+
+/* Formats an event as a line of JSON, returning its length */
+static int32u ev_format(char *const buf, char const *const name,
+                        char const *const what, const int32 value)
+{
+  char *p = buf;
+
+  p += sprintf(p, "{\"time\":%ld,\"turn\":%ld,\"depth\":%d,\"event\":",
+               (long)time(NULL), (long)turn, (int)dun_level);
+  p = ev_quote(p, name);
+  if (what != CNIL)
+  {
+    p += sprintf(p, ",\"what\":");
+    p = ev_quote(p, what);
+  }
+  p += sprintf(p, ",\"value\":%ld}\n", (long)value);
+  return (int32u)(p - buf);
+}
+
+/* Start logging events if MORIA_EVENTS names a file to log them to */
+void event_init()
+{
+  char *p = getenv("MORIA_EVENTS");
+
+  if (p == CNIL || *p == '\0') return;
+  if ((ev_fp = fopen(p, "ab")) == NULL) return;
+  ev_head = ev_tail = 0;
+  ev_done = false;
+  ev_dropped = 0;
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  /* the writer waits on ev_wake, so it must exist before the thread */
+  if ((ev_wake = CreateEvent(NULL, FALSE, FALSE, NULL)) == NULL)
+  {
+    (void) fclose(ev_fp);
+    ev_fp = NULL;
+    return;
+  }
+  InitializeCriticalSection(&ev_lock);
+  if ((ev_thread = CreateThread(NULL, 0, ev_writer, NULL, 0, NULL)) == NULL)
+  {
+    DeleteCriticalSection(&ev_lock);
+    (void) CloseHandle(ev_wake);
+    (void) fclose(ev_fp);
+    ev_fp = NULL;
+    return;
+  }
+#else
+  if (pthread_create(&ev_thread, NULL, ev_writer, NULL) != 0)
+  {
+    (void) fclose(ev_fp);
+    ev_fp = NULL;
+    return;
+  }
+#endif
+  /* if nothing would stop the writer at exit, stop it now */
+  if (atexit(event_close) != 0) event_close();
+}
+
+/* Returns true if events are being logged, so callers can skip building
+   the description of an event that would not be written */
+bool event_active()
+{
+  return ev_fp != NULL && !journal_replaying();
+}
+
+/* Queue an event of the given EV_ type for the writer thread.  what names
+   the monster, item or cause involved, or is CNIL; value is:
+     kill      experience gained
+     damage    hit points lost
+     level     the new dungeon level
+     pickup    number of items picked up
+     identify  number of items identified
+     purchase  price paid
+     death     maximum experience reached
+   Never waits for the disk: if the ring is full the event is dropped. */
+void event_log(const int type, char const *what, const int32 value)
+{
+  char line[2 * EV_LINE_MAX];
+  int32u head, tail, len = 0;
+
+  if (ev_fp == NULL || ev_busy || journal_replaying()) return;
+  ev_busy = 1;
+
+  if (ev_dropped > 0)
+    len = ev_format(line, "dropped", CNIL, (int32)ev_dropped);
+  len += ev_format(&line[len], ev_names[type], what, value);
+  EV_LOCK();
+  head = ev_head;
+  tail = ev_tail;
+  EV_UNLOCK();
+  if (len > EV_RING_SIZE - (head - tail))
+  {
+    ev_dropped++;
+    ev_busy = 0;
+    return;
+  }
+  ev_dropped = 0;
+
+  /* only the game writes past ev_head, so no lock is needed to copy */
+  ev_copy_in(head, line, len);
+  EV_LOCK();
+  ev_head = head + len;
+  ev_signal();
+  EV_UNLOCK();
+  ev_busy = 0;
+}
+
+/* Write out anything still queued and close the event log.  If the game
+   is being ended by a signal that arrived inside event_log(), the lock may
+   be held, so the log is left for the exit to close. */
+void event_close()
+{
+  if (ev_fp == NULL || ev_busy) return;
+  EV_LOCK();
+  ev_done = true;
+  ev_signal();
+  EV_UNLOCK();
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  (void) WaitForSingleObject(ev_thread, INFINITE);
+  (void) CloseHandle(ev_thread);
+  (void) CloseHandle(ev_wake);
+  DeleteCriticalSection(&ev_lock);
+#else
+  (void) pthread_join(ev_thread, NULL);
+#endif
+  (void) fclose(ev_fp);
+  ev_fp = NULL;
+}
@@ -50,6 +50,9 @@ extern int highlight_seams;   /* Highlight magma and quartz       */
 extern int find_ignore_doors; /* Run through open doors           */
 extern int sound_beep_flag;   /* Beep for invalid character       */
 extern int display_counts;    /* Display rest/repeat counts       */
+extern int skip_anim_flag;    /* Don't animate bolts and missiles */
+extern int smart_path_flag;   /* Monsters path round obstacles    */
+extern int lazy_store_flag;   /* Restock stores on return to town */
 
 /* global flags */
 extern int new_level_flag; /* Next level when true                    */
@@ -74,8 +77,6 @@ extern int32u town_seed;            /* Seed for town genera              */
 extern int16 dun_level;             /* Cur dungeon level                 */
 extern int16 missile_ctr;           /* Counter for missiles              */
 extern int msg_flag;                /* Set with first msg                */
-extern vtype old_msg[MAX_SAVE_MSG]; /* Last messages -CJS-               */
-extern int16 last_msg;              /* Where in the array is the last    */
 extern int death;                   /* True if died                      */
 extern int32 turn;                  /* Cur trun of game                  */
 extern int wizard;                  /* Wizard flag                       */
@@ -88,8 +89,8 @@ extern char days[7][29];
 extern int closing_flag; /* Used for closing */
 
 extern int16 cur_height, cur_width; /* Cur dungeon size */
-/*  Following are calculated from max dungeon sizes */
-extern int16 max_panel_rows, max_panel_cols;
+/*  Size of the map view, see init_curses() */
+extern int view_height, view_width;
 extern int panel_row, panel_col;
 extern int panel_row_min, panel_row_max;
 extern int panel_col_min, panel_col_max;
@@ -97,74 +98,83 @@ extern int panel_col_prt, panel_row_prt;
 
 /*  Following are all floor definitions */
 extern cave_type cave[MAX_HEIGHT][MAX_WIDTH];
+extern cave_plane cave_lr, cave_fm, cave_pl, cave_tl;  /* see types.h */
 
 /* Following are player variables */
 extern player_type py;
-extern char *player_title[MAX_CLASS][MAX_PLAYER_LEVEL];
-extern race_type race[MAX_RACES];
-extern background_type background[MAX_BACKGROUND];
-extern int32u player_exp[MAX_PLAYER_LEVEL];
+extern char *const player_title[MAX_CLASS][MAX_PLAYER_LEVEL];
+extern race_type const race[MAX_RACES];
+extern background_type const background[MAX_BACKGROUND];
+extern int32u const player_exp[MAX_PLAYER_LEVEL];
 extern int16u player_hp[MAX_PLAYER_LEVEL];
 extern int16 char_row;
 extern int16 char_col;
 
-extern int8u rgold_adj[MAX_RACES][MAX_RACES];
+extern int8u const rgold_adj[MAX_RACES][MAX_RACES];
 
-extern class_type class[MAX_CLASS];
-extern int16 class_level_adj[MAX_CLASS][MAX_LEV_ADJ];
+extern class_type const class[MAX_CLASS];
+extern int16 const class_level_adj[MAX_CLASS][MAX_LEV_ADJ];
 
 /* Warriors don't have spells, so there is no entry for them. */
-extern spell_type magic_spell[MAX_CLASS-1][31];
-extern char *spell_names[62];
+extern spell_type const magic_spell[MAX_CLASS-1][31];
+extern char *const spell_names[62];
 extern int32u spell_learned;  /* Bit field for spells learnt -CJS- */
 extern int32u spell_worked;  /* Bit field for spells tried -CJS- */
 extern int32u spell_forgotten;  /* Bit field for spells forgotten -JEW- */
 extern int8u spell_order[32];  /* remember order that spells are learned in */
-extern int16u player_init[MAX_CLASS][5];
+extern int16u const player_init[MAX_CLASS][5];
 extern int16 total_winner;
 extern int32 max_score;
 
 /* Following are store definitions */
-extern owner_type owners[MAX_OWNERS];
+extern owner_type const owners[MAX_OWNERS];
 extern store_type store[MAX_STORES];
-extern int16u store_choice[MAX_STORES][STORE_CHOICES];
-extern int (*store_buy[MAX_STORES])();
+extern int16u const store_choice[MAX_STORES][STORE_CHOICES];
+extern int (*const store_buy[MAX_STORES])();
 
 /* Following are treasure arrays  and variables */
-extern treasure_type object_list[MAX_OBJECTS];
+extern treasure_type const object_list[MAX_OBJECTS];
 extern int8u object_ident[OBJECT_IDENT_SIZE];
-extern int16 t_level[MAX_OBJ_LEVEL+1];
+extern int16 const t_level[MAX_OBJ_LEVEL+1];
 extern inven_type t_list[MAX_TALLOC];
+extern dcoord t_row[MAX_TALLOC], t_col[MAX_TALLOC]; /* Where t_list objects are */
 extern inven_type inventory[INVEN_ARRAY_SIZE];
-extern char *special_names[SN_ARRAY_SIZE];
-extern int16 sorted_objects[MAX_DUNGEON_OBJ];
+extern char *const special_names[SN_ARRAY_SIZE];
+extern int16 const sorted_objects[MAX_DUNGEON_OBJ];
 extern int16 inven_ctr;                        /* Total different obj's */
 extern int16 inven_weight;                     /* Cur carried weight    */
 extern int16 equip_ctr;                        /* Cur equipment ctr     */
 extern int16 tcptr;                            /* Cur treasure heap ptr */
 
 /* Following are creature arrays and variables */
-extern creature_type c_list[MAX_CREATURES];
+extern creature_type const c_list[MAX_CREATURES];
 extern monster_type m_list[MAX_MALLOC];
-extern int16 m_level[MAX_MONS_LEVEL+1];
-extern m_attack_type monster_attacks[N_MONS_ATTS];
+extern int16 const m_level[MAX_MONS_LEVEL+1];
+extern m_attack_type const monster_attacks[N_MONS_ATTS];
 extern recall_type c_recall[MAX_CREATURES]; /* Monster memories. -CJS-  */
 extern monster_type blank_monster;          /* Blank monster values     */
 extern int16 mfptr;                         /* Cur free monster ptr     */
 extern int16 mon_tot_mult;                  /* # of repro's of creature */
 
 /* Following are arrays for descriptive pieces */
+extern char *const color_names[MAX_COLORS];
+extern char *const mushroom_names[MAX_MUSH];
+extern char *const wood_names[MAX_WOODS];
+extern char *const metal_names[MAX_METALS];
+extern char *const rock_names[MAX_ROCKS];
+extern char *const amulet_names[MAX_AMULETS];
+/* the same names, in the order magic_init() shuffled them into */
 extern char *colors[MAX_COLORS];
 extern char *mushrooms[MAX_MUSH];
 extern char *woods[MAX_WOODS];
 extern char *metals[MAX_METALS];
 extern char *rocks[MAX_ROCKS];
 extern char *amulets[MAX_AMULETS];
-extern char *syllables[MAX_SYLLABLES];
+extern char *const syllables[MAX_SYLLABLES];
 
-extern int8u blows_table[7][6];
+extern int8u const blows_table[7][6];
 
-extern int16u normal_table[NORMAL_TABLE_SIZE];
+extern int16u const normal_table[NORMAL_TABLE_SIZE];
 
 /* Initialized data which had to be moved from some other file */
 /* Since these get modified, macrsrc.c must be able to access them */
@@ -180,13 +190,27 @@ extern int8u floorsym, wallsym;
 extern char  moriatop[], moriasav[];
 #endif
 
+#ifdef EMBED_ASSETS
+/* assets.c, generated at build time */
+extern asset_type const assets[];
+extern int const asset_count;
+#endif
+
 /* only extern functions declared here, static functions declared inside
    the file that defines them */
+/* anim.c */
+void anim_init();
+void anim_frame();
+void anim_cell(const int ch, const int row, const int col);
+void anim_flush();
+void anim_show();
+
 /* create.c */
 void create_character();
 
 /* creature.c */
 void update_mon();
+void flow_reset();
 int multiply_monster();
 void creatures();
 
@@ -213,6 +237,7 @@ void identify();
 void unmagic_name();
 void objdes();
 void invcopy();
+void inven_objdes();
 void desc_charges();
 void desc_remain();
 
@@ -222,6 +247,12 @@ void dungeon();
 /* eat.c */
 void eat();
 
+/* events.c */
+void event_init();
+bool event_active();
+void event_log(const int type, char const *what, const int32 value);
+void event_close();
+
 /* files.c */
 void init_scorefile();
 void read_times();
@@ -240,6 +271,7 @@ void ident_char();
 int suspend();
 #endif
 void init_curses();
+int set_view();
 void moriaterm();
 void put_buffer();
 void put_qio();
@@ -264,8 +296,23 @@ void pause_exit();
 void save_screen();
 void restore_screen();
 void bell();
+void screen_map_spot();
+void screen_map_area();
+void screen_map_reset();
 void screen_map();
 
+/* journal.c */
+bool journal_pending();
+void journal_start();
+bool journal_replaying();
+void journal_command();
+void journal_key(const char ch);
+bool journal_replay_key(char *const ch);
+bool journal_event(const int event, const bool happened);
+bool journal_sync();
+bool journal_crash();
+void journal_close();
+
 /* magic.c */
 void cast();
 
@@ -290,6 +337,7 @@ int next_to_corr(const int y, const int x);
 int damroll(const int num, const int sides);
 int pdamroll(int8u const *const array);
 bool los(int fromY, int fromX, int toY, int toX);
+int los_path(const int dy, const int dx, int *const ys, int *const xs);
 unsigned char loc_symbol(const int y, const int x);
 bool test_light(const int y, const int x);
 void prt_map();
@@ -297,14 +345,20 @@ bool compact_monsters();
 void add_food(const int num);
 int popm();
 int max_hp(int8u const *const array);
+void cache_monster(monster_type *const mon_ptr);
 bool place_monster(const int y, const int x, const int z, const int slp);
 void place_win_monster();
 int get_mons_num(int level);
 void alloc_monster(const int num, const int dis, int slp);
 bool summon_monster(int *y, int *x, const int slp);
 bool summon_undead(int *y, int *x);
+void cave_fill(cave_plane plane, const int y1, const int x1, const int y2,
+               const int x2, const bool v);
+void cave_near_floor(cave_plane plane, const int y1, const int x1,
+                     const int y2, const int x2);
+void set_tptr(const int y, const int x, const dindex i);
 int popt();
-void pusht(const int8u x);
+void pusht(const dindex x);
 bool magik(const int chance);
 int m_bonus(const int base, const int max_std, const int level);
 
@@ -321,6 +375,7 @@ void place_object();
 void alloc_object();
 void random_object();
 void cnv_stat();
+void status_forget();
 void prt_stat();
 void prt_field();
 int stat_adj();
@@ -481,16 +536,47 @@ void msdos_noraw();
 int msdos_getch();
 #endif
 
+/* msglog.c */
+void msglog_clear();
+int msglog_intern(char const *const text);
+bool msglog_append(const int text, const int count);
+void msglog_add(char const *const msg);
+int32u msglog_size();
+int32u msglog_texts();
+char const *msglog_text(const int32u n);
+void msglog_entry(const int32u n, int *const text, int *const count);
+void msglog_line(const int32u n, char *const buf);
+void msglog_browse(int32u lines);
+
 /* potions.c */
 void quaff();
 
 /* prayer.c */
 void pray();
 
+/* profile.c */
+#ifdef PROFILE
+void prof_enter(const int id);
+void prof_leave(const int id);
+void prof_describe(const int id, char *const buf);
+void prof_dump();
+#define PROF_ENTER(id) prof_enter(id)
+#define PROF_LEAVE(id) prof_leave(id)
+#else
+#define PROF_ENTER(id) ((void) 0)
+#define PROF_LEAVE(id) ((void) 0)
+#endif
+
 /* recall.c */
 int bool_roff_recall();
 int roff_recall();
 
+/* record.c */
+void record_init();
+bool record_active();
+bool record_frame(char const *buf, const int len);
+void record_close();
+
 /* rnd.c */
 int32u get_rnd_seed();
 void set_rnd_seed();
@@ -499,6 +585,7 @@ int32 rnd();
 /* save.c */
 bool save_char();
 bool _save_char(char const *const fnam);
+bool checkpoint_char();
 bool get_char(int *generate);
 bool ver_lt(const int8u lmaj, const int8u lmin, const int8u lpat,
             const int8u rmaj, const int8u rmin, const int8u rpat);
@@ -538,6 +625,12 @@ void ignore_signals();
 void default_signals();
 void restore_signals();
 
+/* spectate.c */
+void spectate_init();
+void spectate_frame();
+void spectate_close();
+int spectate_view(char const *path);
+
 /* spells.c */
 void monster_name();
 void lower_monster_name();
@@ -620,6 +713,8 @@ void store_carry();
 void store_destroy();
 void store_init();
 void store_maint();
+void store_turnover();
+void store_catch_up();
 int noneedtobargain();
 void updatebargain();
 
@@ -651,6 +746,7 @@ void aim();
 void wizard_light();
 void change_character();
 void wizard_create();
+void wizard_profile();
 
 #ifdef unix
 /* call functions which expand tilde before calling open/fopen */
@@ -111,20 +111,117 @@ void init_scorefile()
 }
 
 #ifndef MAC
+/* A data file being read a line at a time.  When the game is built with
+   EMBED_ASSETS, the news, hours and help files are built into it (see
+   cmake/embed_assets.cmake) and are read from there, without going to
+   the disk at all; any other file is read from the disk as usual.  */
+typedef struct data_file
+{
+  FILE *fp;
+#ifdef EMBED_ASSETS
+  asset_type const *asset;
+  int line;
+#endif
+} data_file;
+
+#ifdef EMBED_ASSETS
+/* Finds the asset built in under the name of the file filename, or returns
+   NULL if there is none.  The asset table is sorted by name.  */
+static asset_type const *find_asset(filename)
+char const *filename;
+{
+  register char const *name, *p;
+  register int low, high, mid, cmp;
+
+  /* only the name counts, not the directory it is in */
+  name = filename;
+  for (p = filename; *p != '\0'; p++)
+    if (*p == '/' || *p == '\\' || *p == ':')
+      name = p + 1;
+  low = 0;
+  high = asset_count - 1;
+  while (low <= high)
+    {
+      mid = (low + high) / 2;
+      cmp = strcmp(name, assets[mid].name);
+      if (cmp == 0)
+	return &assets[mid];
+      else if (cmp < 0)
+	high = mid - 1;
+      else
+	low = mid + 1;
+    }
+  return NULL;
+}
+#endif
+
+/* Opens filename for reading, returns false if it can not be found */
+static int data_open(df, filename)
+data_file *df;
+char const *filename;
+{
+#ifdef EMBED_ASSETS
+  df->line = 0;
+  if ((df->asset = find_asset(filename)) != NULL)
+    {
+      df->fp = NULL;
+      return true;
+    }
+#endif
+  df->fp = fopen(filename, "r");
+  return df->fp != NULL;
+}
+
+/* Reads the next line into buf, which holds len bytes, as fgets() would;
+   returns false at the end of the file */
+static int data_gets(df, buf, len)
+data_file *df;
+char *buf;
+int len;
+{
+#ifdef EMBED_ASSETS
+  register asset_type const *a_ptr;
+  register int32u start, size;
+
+  a_ptr = df->asset;
+  if (a_ptr != NULL)
+    {
+      if (df->line >= a_ptr->line_count)
+	return false;
+      start = a_ptr->lines[df->line];
+      size = a_ptr->lines[df->line + 1] - start;
+      if (size > len - 1)
+	size = len - 1;
+      (void) memcpy(buf, a_ptr->text + start, (size_t)size);
+      buf[size] = '\0';
+      df->line++;
+      return true;
+    }
+#endif
+  return fgets(buf, len, df->fp) != CNIL;
+}
+
+static void data_close(df)
+data_file *df;
+{
+  if (df->fp != NULL)
+    (void) fclose(df->fp);
+}
+
 /* Attempt to open the intro file			-RAK-	 */
 /* This routine also checks the hours file vs. what time it is	-Doc */
 void read_times()
 {
   vtype in_line;
   register int i;
-  FILE *file1;
+  data_file file1;
 
 #ifdef MORIA_HOU
   /* Attempt to read hours.dat.	 If it does not exist,	   */
   /* inform the user so he can tell the wizard about it	 */
-  if ((file1 = fopen(MORIA_HOU, "r")) != NULL)
+  if (data_open(&file1, MORIA_HOU))
     {
-      while (fgets(in_line, 80, file1) != CNIL)
+      while (data_gets(&file1, in_line, 80))
 	if (strlen(in_line) > 3)
 	  {
 	    if (!strncmp(in_line, "SUN:", 4))
@@ -142,7 +239,7 @@ void read_times()
 	    else if (!strncmp(in_line, "SAT:", 4))
 	      (void) strcpy(days[6], in_line);
 	  }
-      (void) fclose(file1);
+      data_close(&file1);
     }
   else
     {
@@ -156,32 +253,32 @@ void read_times()
   /* Check the hours, if closed	then exit. */
   if (!check_time())
     {
-      if ((file1 = fopen(MORIA_HOU, "r")) != NULL)
+      if (data_open(&file1, MORIA_HOU))
 	{
 	  clear_screen();
 #ifdef VMS
 	  restore_screen();
 #endif
-	  for (i = 0; fgets(in_line, 80, file1) != CNIL; i++)
+	  for (i = 0; data_gets(&file1, in_line, 80); i++)
 	    put_buffer(in_line, i, 0);
 	  pause_line (23);
-	  (void) fclose(file1);
+	  data_close(&file1);
 	}
       exit_game();
     }
 #endif
 
   /* Print the introduction message, news, etc.		 */
-  if ((file1 = fopen(MORIA_MOR, "r")) != NULL)
+  if (data_open(&file1, MORIA_MOR))
     {
       clear_screen();
 #ifdef VMS
       restore_screen();
 #endif
-      for (i = 0; fgets(in_line, 80, file1) != CNIL; i++)
+      for (i = 0; data_gets(&file1, in_line, 80); i++)
 	put_buffer(in_line, i, 0);
       pause_line(23);
-      (void) fclose(file1);
+      data_close(&file1);
     }
 }
 #endif
@@ -197,12 +294,11 @@ char *filename;
 #else
 {
   bigvtype tmp_str;
-  FILE *file;
+  data_file file;
   char input;
-  int i;
+  int i, more;
 
-  file = fopen(filename, "r");
-  if (file == NULL)
+  if (!data_open(&file, filename))
     {
       (void) sprintf (tmp_str, "Can not find help file \"%s\".\n", filename);
       prt (tmp_str, 0, 0);
@@ -211,19 +307,22 @@ char *filename;
 
   save_screen();
 
-  while (!feof(file))
+  more = true;
+  while (more)
     {
       clear_screen();
       for (i = 0; i < 23; i++)
-	if (fgets (tmp_str, BIGVTYPESIZ-1, file) != CNIL)
+	if (data_gets (&file, tmp_str, BIGVTYPESIZ-1))
 	  put_buffer (tmp_str, i, 0);
+	else
+	  more = false;
       prt("[Press any key to continue.]", 23, 23);
       input = inkey();
       if (input == ESCAPE)
 	break;
     }
 
-  (void) fclose(file);
+  data_close(&file);
   restore_screen();
 }
 #endif
@@ -144,6 +144,10 @@ static void blank_cave()
   (void)memset((char *)&cave[0][0], 0, sizeof (cave));
 #endif
 #endif
+  cave_fill(cave_lr, 0, 0, MAX_HEIGHT - 1, MAX_WIDTH - 1, false);
+  cave_fill(cave_fm, 0, 0, MAX_HEIGHT - 1, MAX_WIDTH - 1, false);
+  cave_fill(cave_pl, 0, 0, MAX_HEIGHT - 1, MAX_WIDTH - 1, false);
+  cave_fill(cave_tl, 0, 0, MAX_HEIGHT - 1, MAX_WIDTH - 1, false);
 }
 
 
@@ -268,7 +272,7 @@ int y, x;
 
   cur_pos = popt();
   cave_ptr = &cave[y][x];
-  cave_ptr->tptr = cur_pos;
+  set_tptr(y, x, cur_pos);
   invcopy(&t_list[cur_pos], OBJ_OPEN_DOOR);
   cave_ptr->fval  = CORR_FLOOR;
 }
@@ -282,7 +286,7 @@ int y, x;
 
   cur_pos = popt();
   cave_ptr = &cave[y][x];
-  cave_ptr->tptr = cur_pos;
+  set_tptr(y, x, cur_pos);
   invcopy(&t_list[cur_pos], OBJ_OPEN_DOOR);
   cave_ptr->fval  = CORR_FLOOR;
   t_list[cur_pos].p1 = 1;
@@ -297,7 +301,7 @@ int y, x;
 
   cur_pos = popt();
   cave_ptr = &cave[y][x];
-  cave_ptr->tptr = cur_pos;
+  set_tptr(y, x, cur_pos);
   invcopy(&t_list[cur_pos], OBJ_CLOSED_DOOR);
   cave_ptr->fval  = BLOCKED_FLOOR;
 }
@@ -311,7 +315,7 @@ int y, x;
 
   cur_pos = popt();
   cave_ptr = &cave[y][x];
-  cave_ptr->tptr = cur_pos;
+  set_tptr(y, x, cur_pos);
   invcopy(&t_list[cur_pos], OBJ_CLOSED_DOOR);
   cave_ptr->fval  = BLOCKED_FLOOR;
   t_list[cur_pos].p1 = randint(10) + 10;
@@ -326,7 +330,7 @@ int y, x;
 
   cur_pos = popt();
   cave_ptr = &cave[y][x];
-  cave_ptr->tptr = cur_pos;
+  set_tptr(y, x, cur_pos);
   invcopy(&t_list[cur_pos], OBJ_CLOSED_DOOR);
   cave_ptr->fval  = BLOCKED_FLOOR;
   t_list[cur_pos].p1 = -randint(10) - 10;
@@ -341,8 +345,12 @@ int y, x;
 
   cur_pos = popt();
   cave_ptr = &cave[y][x];
-  cave_ptr->tptr = cur_pos;
+  set_tptr(y, x, cur_pos);
   invcopy(&t_list[cur_pos], OBJ_SECRET_DOOR);
+#ifdef MSDOS
+  /* looks like a wall, whatever symbol MORIA.CNF picked for those */
+  t_list[cur_pos].tchar = wallsym;
+#endif
   cave_ptr->fval  = BLOCKED_FLOOR;
 }
 
@@ -386,7 +394,7 @@ int y, x;
   if (cave_ptr->tptr != 0)
     (void) delete_object(y, x);
   cur_pos = popt();
-  cave_ptr->tptr = cur_pos;
+  set_tptr(y, x, cur_pos);
   invcopy(&t_list[cur_pos], OBJ_UP_STAIR);
 }
 
@@ -402,7 +410,7 @@ int y, x;
   if (cave_ptr->tptr != 0)
     (void) delete_object(y, x);
   cur_pos = popt();
-  cave_ptr->tptr = cur_pos;
+  set_tptr(y, x, cur_pos);
   invcopy(&t_list[cur_pos], OBJ_DOWN_STAIR);
 }
 
@@ -527,6 +535,9 @@ int yval, xval;
   x_left   = xval - randint(11);
   x_right  = xval + randint(11);
 
+  /* the room and its walls */
+  cave_fill(cave_lr, y_height - 1, x_left - 1, y_depth + 1, x_right + 1, true);
+
   /* the x dim of rooms tends to be much larger than the y dim, so don't
      bother rewriting the y loop */
 
@@ -536,7 +547,6 @@ int yval, xval;
       for (j = x_left; j <= x_right; j++)
 	{
 	  c_ptr->fval  = floor;
-	  c_ptr->lr = true;
 	  c_ptr++;
 	}
     }
@@ -545,10 +555,8 @@ int yval, xval;
     {
       c_ptr = &cave[i][x_left-1];
       c_ptr->fval   = GRANITE_WALL;
-      c_ptr->lr = true;
       c_ptr = &cave[i][x_right+1];
       c_ptr->fval  = GRANITE_WALL;
-      c_ptr->lr = true;
     }
 
   c_ptr = &cave[y_height - 1][x_left];
@@ -556,10 +564,8 @@ int yval, xval;
   for (i = x_left; i <= x_right; i++)
     {
       c_ptr->fval  = GRANITE_WALL;
-      c_ptr->lr = true;
       c_ptr++;
       d_ptr->fval   = GRANITE_WALL;
-      d_ptr->lr = true;
       d_ptr++;
     }
 }
@@ -588,6 +594,9 @@ int yval, xval;
       x_left   = xval - randint(11);
       x_right  = xval + randint(11);
 
+      cave_fill(cave_lr, y_height - 1, x_left - 1, y_depth + 1, x_right + 1,
+		true);
+
       /* the x dim of rooms tends to be much larger than the y dim, so don't
 	 bother rewriting the y loop */
 
@@ -597,7 +606,6 @@ int yval, xval;
 	  for (j = x_left; j <= x_right; j++)
 	    {
 	      c_ptr->fval  = floor;
-	      c_ptr->lr = true;
 	      c_ptr++;
 	    }
 	}
@@ -605,32 +613,20 @@ int yval, xval;
 	{
 	  c_ptr = &cave[i][x_left-1];
 	  if (c_ptr->fval != floor)
-	    {
-	      c_ptr->fval  = GRANITE_WALL;
-	      c_ptr->lr = true;
-	    }
+	    c_ptr->fval  = GRANITE_WALL;
 	  c_ptr = &cave[i][x_right+1];
 	  if (c_ptr->fval != floor)
-	    {
-	      c_ptr->fval  = GRANITE_WALL;
-	      c_ptr->lr = true;
-	    }
+	    c_ptr->fval  = GRANITE_WALL;
 	}
       c_ptr = &cave[y_height - 1][x_left];
       d_ptr = &cave[y_depth + 1][x_left];
       for (i = x_left; i <= x_right; i++)
 	{
 	  if (c_ptr->fval != floor)
-	    {
-	      c_ptr->fval  = GRANITE_WALL;
-	      c_ptr->lr = true;
-	    }
+	    c_ptr->fval  = GRANITE_WALL;
 	  c_ptr++;
 	  if (d_ptr->fval != floor)
-	    {
-	      d_ptr->fval  = GRANITE_WALL;
-	      d_ptr->lr = true;
-	    }
+	    d_ptr->fval  = GRANITE_WALL;
 	  d_ptr++;
 	}
     }
@@ -661,6 +657,9 @@ int yval, xval;
   x_left   = xval - 11;
   x_right  = xval + 11;
 
+  /* the room and its walls */
+  cave_fill(cave_lr, y_height - 1, x_left - 1, y_depth + 1, x_right + 1, true);
+
   /* the x dim of rooms tends to be much larger than the y dim, so don't
      bother rewriting the y loop */
 
@@ -670,7 +669,6 @@ int yval, xval;
       for (j = x_left; j <= x_right; j++)
 	{
 	  c_ptr->fval  = floor;
-	  c_ptr->lr = true;
 	  c_ptr++;
 	}
     }
@@ -678,20 +676,16 @@ int yval, xval;
     {
       c_ptr = &cave[i][x_left-1];
       c_ptr->fval   = GRANITE_WALL;
-      c_ptr->lr = true;
       c_ptr = &cave[i][x_right+1];
       c_ptr->fval  = GRANITE_WALL;
-      c_ptr->lr = true;
     }
   c_ptr = &cave[y_height - 1][x_left];
   d_ptr = &cave[y_depth + 1][x_left];
   for (i = x_left; i <= x_right; i++)
     {
       c_ptr->fval  = GRANITE_WALL;
-      c_ptr->lr = true;
       c_ptr++;
       d_ptr->fval   = GRANITE_WALL;
-      d_ptr->lr = true;
       d_ptr++;
     }
   /* The inner room		*/
@@ -917,72 +911,56 @@ int yval, xval;
   y_depth  = yval + tmp;
   x_left   = xval - 1;
   x_right  = xval + 1;
+  cave_fill(cave_lr, y_height - 1, x_left - 1, y_depth + 1, x_right + 1, true);
   for (i = y_height; i <= y_depth; i++)
     for (j = x_left; j <= x_right; j++)
       {
 	c_ptr = &cave[i][j];
 	c_ptr->fval = floor;
-	c_ptr->lr = true;
       }
   for (i = (y_height - 1); i <= (y_depth + 1); i++)
     {
       c_ptr = &cave[i][x_left-1];
       c_ptr->fval  = GRANITE_WALL;
-      c_ptr->lr = true;
       c_ptr = &cave[i][x_right+1];
       c_ptr->fval  = GRANITE_WALL;
-      c_ptr->lr = true;
     }
   for (i = x_left; i <= x_right; i++)
     {
       c_ptr = &cave[y_height-1][i];
       c_ptr->fval  = GRANITE_WALL;
-      c_ptr->lr = true;
       c_ptr = &cave[y_depth+1][i];
       c_ptr->fval  = GRANITE_WALL;
-      c_ptr->lr = true;
     }
   tmp = 2 + randint(9);
   y_height = yval - 1;
   y_depth  = yval + 1;
   x_left   = xval - tmp;
   x_right  = xval + tmp;
+  cave_fill(cave_lr, y_height - 1, x_left - 1, y_depth + 1, x_right + 1, true);
   for (i = y_height; i <= y_depth; i++)
     for (j = x_left; j <= x_right; j++)
       {
 	c_ptr = &cave[i][j];
 	c_ptr->fval = floor;
-	c_ptr->lr = true;
       }
   for (i = (y_height - 1); i <= (y_depth + 1); i++)
     {
       c_ptr = &cave[i][x_left-1];
       if (c_ptr->fval != floor)
-	{
-	  c_ptr->fval  = GRANITE_WALL;
-	  c_ptr->lr = true;
-	}
+	c_ptr->fval  = GRANITE_WALL;
       c_ptr = &cave[i][x_right+1];
       if (c_ptr->fval != floor)
-	{
-	  c_ptr->fval  = GRANITE_WALL;
-	  c_ptr->lr = true;
-	}
+	c_ptr->fval  = GRANITE_WALL;
     }
   for (i = x_left; i <= x_right; i++)
     {
       c_ptr = &cave[y_height-1][i];
       if (c_ptr->fval != floor)
-	{
-	  c_ptr->fval  = GRANITE_WALL;
-	  c_ptr->lr = true;
-	}
+	c_ptr->fval  = GRANITE_WALL;
       c_ptr = &cave[y_depth+1][i];
       if (c_ptr->fval != floor)
-	{
-	  c_ptr->fval  = GRANITE_WALL;
-	  c_ptr->lr = true;
-	}
+	c_ptr->fval  = GRANITE_WALL;
     }
   /* Special features.			*/
   switch(randint(4))
@@ -1260,11 +1238,12 @@ static void cave_gen()
       int endx;
       int endy;
     };
-  int room_map[20][20];
+  int room_map[2*MAX_HEIGHT/SCREEN_HEIGHT][2*MAX_WIDTH/SCREEN_WIDTH];
   register int i, j, k;
   int y1, x1, y2, x2, pick1, pick2, tmp;
   int row_rooms, col_rooms, alloc_level;
-  int16 yloc[400], xloc[400];
+  int16 yloc[(2*MAX_HEIGHT/SCREEN_HEIGHT) * (2*MAX_WIDTH/SCREEN_WIDTH)];
+  int16 xloc[(2*MAX_HEIGHT/SCREEN_HEIGHT) * (2*MAX_WIDTH/SCREEN_WIDTH)];
 
   row_rooms = 2*(cur_height/SCREEN_HEIGHT);
   col_rooms = 2*(cur_width /SCREEN_WIDTH);
@@ -1392,7 +1371,7 @@ int store_num, y, x;
   c_ptr = &cave[i][j];
   c_ptr->fval  = CORR_FLOOR;
   cur_pos = popt();
-  c_ptr->tptr = cur_pos;
+  set_tptr(i, j, cur_pos);
   invcopy(&t_list[cur_pos], OBJ_STORE_DOOR + store_num);
 }
 
@@ -1454,7 +1433,7 @@ static void town_gen()
 	  for (j = 0; j < cur_width; j++)
 	    {
 	      if (c_ptr->fval != DARK_FLOOR)
-		c_ptr->pl = true;
+		cave_on(cave_pl, i, j);
 	      c_ptr++;
 	    }
 #ifdef MAC
@@ -1465,20 +1444,10 @@ static void town_gen()
     }
   else
     {		/* Day	*/
-      for (i = 0; i < cur_height; i++)
-	{
-	  c_ptr = &cave[i][0];
-	  for (j = 0; j < cur_width; j++)
-	    {
-	      c_ptr->pl = true;
-	      c_ptr++;
-	    }
-#ifdef MAC
-	  SystemTask ();
-#endif
-	}
+      cave_fill(cave_pl, 0, 0, cur_height - 1, cur_width - 1, true);
       alloc_monster(MIN_MALLOC_TD, 3, true);
     }
+  store_catch_up();
   store_maint();
 }
 
@@ -1486,6 +1455,7 @@ static void town_gen()
 /* Generates a random dungeon level			-RAK-	*/
 void generate_cave()
 {
+  PROF_ENTER(PROF_GENERATE_CAVE);
   panel_row_min	= 0;
   panel_row_max	= 0;
   panel_col_min	= 0;
@@ -1500,28 +1470,23 @@ void generate_cave()
   tlink();
   mlink();
   blank_cave();
+  screen_map_reset();
+  flow_reset();
 
   if (dun_level == 0)
     {
       cur_height = SCREEN_HEIGHT;
       cur_width	 = SCREEN_WIDTH;
-      max_panel_rows = (cur_height/SCREEN_HEIGHT)*2 - 2;
-      max_panel_cols = (cur_width /SCREEN_WIDTH )*2 - 2;
-      panel_row = max_panel_rows;
-      panel_col = max_panel_cols;
       town_gen();
     }
   else
     {
       cur_height = MAX_HEIGHT;
       cur_width	 = MAX_WIDTH;
-      max_panel_rows = (cur_height/SCREEN_HEIGHT)*2 - 2;
-      max_panel_cols = (cur_width /SCREEN_WIDTH )*2 - 2;
-      panel_row = max_panel_rows;
-      panel_col = max_panel_cols;
       cave_gen();
     }
 #ifdef MAC
   macendwait ();
 #endif
+  PROF_LEAVE(PROF_GENERATE_CAVE);
 }
@@ -343,7 +343,6 @@ void init_curses()
       exit(1);
     }
 #if defined(_MSC_VER) || defined(__MINGW32__)
-  resize_term(24, 80);
   curs_set(1);
 #endif
   if (LINES < 24 || COLS < 80)	 /* Check we have enough screen. -CJS- */
@@ -351,6 +350,14 @@ void init_curses()
       (void) printf("Screen too small for moria (need 80x24, got %lux%lu).\n", COLS, LINES);
       exit (1);
     }
+  /* the map view gets whatever the message line, the status line and the
+     stat block leave of the screen, so that a level scrolls less often */
+  view_height = LINES - 2;
+  if (view_height > VIEW_MAX_HEIGHT)
+    view_height = VIEW_MAX_HEIGHT;
+  view_width = COLS - 13;
+  if (view_width > VIEW_MAX_WIDTH)
+    view_width = VIEW_MAX_WIDTH;
 #ifdef SIGTSTP
 #if defined(atarist) && defined(__GNUC__)
   (void) signal (SIGTSTP, (__Sigfunc)suspend);
@@ -404,6 +411,25 @@ void init_curses()
 }
 #endif
 
+/* Makes the map view height by width squares, if that is a size the view
+   can have on this screen.  Returns true if it did.  */
+int set_view(height, width)
+int height, width;
+{
+#ifdef MAC
+  if (height + 2 > SCRN_ROWS || width + 13 > SCRN_COLS)
+#else
+  if (height + 2 > LINES || width + 13 > COLS)
+#endif
+    return false;
+  if (height < SCREEN_HEIGHT || height > VIEW_MAX_HEIGHT
+      || width < SCREEN_WIDTH || width > VIEW_MAX_WIDTH)
+    return false;
+  view_height = height;
+  view_width = width;
+  return true;
+}
+
 /* Set up the terminal into a suitable state for moria.	 -CJS- */
 void moriaterm()
 #ifdef MAC
@@ -539,7 +565,13 @@ void put_qio()
 #ifdef MAC
   UpdateScreen();
 #else
+  /* The screen catches up in one go once the journal has been replayed */
+  if (journal_replaying())
+    return;
+  PROF_ENTER(PROF_PUT_QIO);
+  spectate_frame();	   /* Must come before refresh() resets touched lines */
   (void) refresh();
+  PROF_LEAVE(PROF_PUT_QIO);
 #endif
 }
 
@@ -819,6 +851,36 @@ void shell_out()
 #endif
 #endif
 
+#ifndef MAC
+/* Deal with the end of input where inkey() wanted a key, which happens if
+   the process gets a HANGUP signal.  Returns ESCAPE if the game goes on. */
+static char inkey_eof()
+{
+  eof_flag++;
+  /* avoid infinite loops while trying to call inkey() for a -more-
+     prompt. */
+  msg_flag = false;
+
+  (void) refresh ();
+  if (!character_generated || character_saved)
+    exit_game();
+  disturb(1, 0);
+  if (eof_flag > 100)
+    {
+      /* just in case, to make sure that the process eventually dies */
+      panic_save = true;
+      (void) strcpy(died_from, "(end of input: panic saved)");
+      if (!save_char())
+	{
+	  (void) strcpy(died_from, "panic: unexpected eof");
+	  death = true;
+	}
+      exit_game();
+    }
+  return ESCAPE;
+}
+#endif
+
 /* Returns a single character input from the terminal.	This silently -CJS-
    consumes ^R to redraw the screen and reset the terminal, so that this
    operation can always be performed at any input prompt.  inkey() never
@@ -850,12 +912,21 @@ char inkey()
 #else
 {
   int i;
+  char ch;
 #ifdef VMS
   vtype tmp_str;
 #endif
 
   put_qio();			/* Dump IO buffer		*/
   command_count = 0;  /* Just to be safe -CJS- */
+  if (journal_replaying())
+    {
+      if (journal_event(JE_EOF, false))
+	return inkey_eof();
+      if (journal_replay_key(&ch))
+	return(ch);
+      put_qio();		/* Journal has run out, show where we are */
+    }
   while (true)
     {
 #ifdef MSDOS
@@ -908,31 +979,16 @@ char inkey()
       /* some machines may not sign extend. */
       if (i == EOF)
 	{
-	  eof_flag++;
-	  /* avoid infinite loops while trying to call inkey() for a -more-
-	     prompt. */
-	  msg_flag = false;
-
-	  (void) refresh ();
-	  if (!character_generated || character_saved)
-	    exit_game();
-	  disturb(1, 0);
-	  if (eof_flag > 100)
-	    {
-	      /* just in case, to make sure that the process eventually dies */
-	      panic_save = true;
-	      (void) strcpy(died_from, "(end of input: panic saved)");
-	      if (!save_char())
-		{
-		  (void) strcpy(died_from, "panic: unexpected eof");
-		  death = true;
-		}
-	      exit_game();
-	    }
-	  return ESCAPE;
+	  /* journalled as an event rather than as the ESCAPE it turns into,
+	     since it also stops the game */
+	  (void) journal_event(JE_EOF, true);
+	  return inkey_eof();
 	}
       if (i != CTRL('R'))
-	return (char)i;
+	{
+	  journal_key((char)i);
+	  return (char)i;
+	}
 #ifdef VMS
       /* Refresh does not work right under VMS, so use a brute force. */
       overwrite (stdscr, tempscr);
@@ -1046,6 +1102,7 @@ int col;
   line.right = SCRN_COLS;
   line.bottom = row + 1;
   DEraseScreen(&line);
+  status_forget(row, row, col);
 }
 #else
 {
@@ -1053,6 +1110,7 @@ int col;
     msg_print(CNIL);
   (void) move(row, col);
   clrtoeol();
+  status_forget(row, row, col);
 }
 #endif
 
@@ -1070,11 +1128,13 @@ void clear_screen()
   area.right = SCRN_COLS;
   area.bottom = SCRN_ROWS;
   DEraseScreen(&area);
+  status_forget(0, SCRN_ROWS-1, 0);
 }
 #else
 {
   if (msg_flag)
     msg_print(CNIL);
+  status_forget(0, LINES - 1, 0);
 #ifdef VMS
   /* Clear doesn't work right under VMS, so use brute force. */
   (void) clearok (stdscr, true);
@@ -1097,11 +1157,13 @@ int row;
   area.right = SCRN_COLS;
   area.bottom = SCRN_ROWS;
   DEraseScreen(&area);
+  status_forget(row, SCRN_ROWS-1, 0);
 }
 #else
 {
   (void) move(row, 0);
   clrtobot();
+  status_forget(row, LINES - 1, 0);
 }
 #endif
 
@@ -1121,6 +1183,7 @@ int col;
 {
   char cnow, anow;
 
+  screen_map_spot(row, col);
   row -= panel_row_prt;/* Real co-ords convert to screen positions */
   col -= panel_col_prt;
 
@@ -1140,6 +1203,7 @@ int col;
   const cchar_t wch = ToUTF(ch);
 #endif
 
+  screen_map_spot(row, col);
   row -= panel_row_prt;/* Real co-ords convert to screen positions */
   col -= panel_col_prt;
 #if defined(PDC_WIDE)
@@ -1225,6 +1289,7 @@ int col;
   line.right = SCRN_COLS;
   line.bottom = row + 1;
   DEraseScreen(&line);
+  status_forget(row, row, col);
 
   put_buffer(str_buff, row, col);
 }
@@ -1234,6 +1299,7 @@ int col;
     msg_print(CNIL);
   (void) move(row, col);
   clrtoeol();
+  status_forget(row, row, col);
   put_buffer(str_buff, row, col);
 }
 #endif
@@ -1253,6 +1319,9 @@ int row, col;
 #endif
 
 
+/* length of what is on the message line, for joining on short messages */
+static int msg_line_len = 0;
+
 /* Outputs message to top line of screen				*/
 /* These messages are kept for later reference.	 */
 void msg_print(str_buff)
@@ -1267,7 +1336,7 @@ char *str_buff;
 
   if (msg_flag)
     {
-      old_len = strlen(old_msg[last_msg]) + 1;
+      old_len = msg_line_len + 1;
 
       /* If the new message and the old message are short enough, we want
 	 display them together on the same line.  So we don't flush the old
@@ -1324,18 +1393,14 @@ char *str_buff;
       if (combine_messages)
 	{
 	  put_buffer (str_buff, MSG_LINE, old_len + 2);
-	  strcat (old_msg[last_msg], "  ");
-	  strcat (old_msg[last_msg], str_buff);
+	  msg_line_len = old_len + 1 + new_len;
 	}
       else
 	{
 	  put_buffer(str_buff, MSG_LINE, 0);
-	  last_msg++;
-	  if (last_msg >= MAX_SAVE_MSG)
-	    last_msg = 0;
-	  (void) strncpy(old_msg[last_msg], str_buff, VTYPESIZ);
-	  old_msg[last_msg][VTYPESIZ - 1] = '\0';
+	  msg_line_len = strlen(str_buff);
 	}
+      msglog_add(str_buff);
     }
   else
     msg_flag = false;
@@ -1571,6 +1636,7 @@ void save_screen()
 void restore_screen()
 {
   mac_restore_screen();
+  status_forget(0, SCRN_ROWS-1, 0);
 }
 #else
 void save_screen()
@@ -1582,6 +1648,8 @@ void restore_screen()
 {
   overwrite(savescr, stdscr);
   touchwin(stdscr);
+  /* the status display may have been changed over what is put back */
+  status_forget(0, LINES - 1, 0);
 }
 #endif
 
@@ -1622,22 +1690,86 @@ void bell()
 #   define CH(x)	(screen_border[0][x])
 #endif
 
-  /* Display highest priority object in the RATIO by RATIO area */
-#define	RATIO 3
+  /* Display highest priority object in the RATIO by RATIO area, which
+     must shrink the whole dungeon to fit on the screen */
+#define	RATIO (3 * DUN_SCALE)
+
+/* size of the screen_map() overview, in RATIO by RATIO blocks */
+#define OV_HEIGHT (MAX_HEIGHT / RATIO)
+#define OV_WIDTH  (MAX_WIDTH / RATIO)
+
+/* Cached overview for screen_map(). Each entry holds the highest priority
+   symbol of one block, and is only recomputed when a square in the block may
+   have changed since it was last computed: when something is drawn there,
+   when one of its cave flags is set or cleared, or when an object is put
+   there or a monster moves in or out, whether or not it is on the panel.
+   Rows are null terminated so they can be output as strings. */
+static int8u ov_map[OV_HEIGHT][OV_WIDTH + 1];
+static bool ov_dirty[OV_HEIGHT][OV_WIDTH];
+static bool ov_all_dirty = true;
+
+/* Note that the symbol at y, x may have changed */
+void screen_map_spot(y, x)
+int y, x;
+{
+  if (y >= 0 && y < MAX_HEIGHT && x >= 0 && x < MAX_WIDTH)
+    ov_dirty[y / RATIO][x / RATIO] = true;
+}
+
+/* Note that any symbol in the given (inclusive) area may have changed */
+void screen_map_area(y1, x1, y2, x2)
+int y1, x1, y2, x2;
+{
+  register int i, j;
+
+  if (y1 < 0) y1 = 0;
+  if (x1 < 0) x1 = 0;
+  if (y2 >= MAX_HEIGHT) y2 = MAX_HEIGHT - 1;
+  if (x2 >= MAX_WIDTH) x2 = MAX_WIDTH - 1;
+  for (i = y1 / RATIO; i <= y2 / RATIO; i++)
+    for (j = x1 / RATIO; j <= x2 / RATIO; j++)
+      ov_dirty[i][j] = true;
+}
+
+/* Note that the whole level may have changed, e.g. on a new level or after
+   something that affects cells outside of the panel */
+void screen_map_reset()
+{
+  ov_all_dirty = true;
+}
+
+/* Recompute one block of the overview */
+static void screen_map_block(row, col, priority)
+int row, col;
+int *priority;
+{
+  register int i, j;
+  int8u tmp, sym;
+
+  sym = ' ';
+  for (i = row * RATIO; i < (row + 1) * RATIO; i++)
+    for (j = col * RATIO; j < (col + 1) * RATIO; j++)
+    {
+      tmp = loc_symbol(i, j);
+      if (priority[sym] < priority[tmp])
+        sym = tmp;
+    }
+  ov_map[row][col] = sym;
+  ov_dirty[row][col] = false;
+}
 
 void screen_map()
 {
-  register int	i, j;
+  register int	i;
   static int8u screen_border[2][6] = {
     {'+', '+', '+', '+', '-', '|'},	/* normal chars */
     {201, 187, 200, 188, 205, 186}	/* graphics chars */
   };
-  int8u map[MAX_WIDTH / RATIO + 1];
-  int8u tmp;
+  int8u *map;
   int priority[256];
-  int row, orow, col, myrow, mycol = 0;
+  int row, col, myrow, mycol = 0;
+  bool full;
 #if defined(PDC_WIDE)
-  register int k;
   wchar_t wprntscrnbuf[80];
 #elif !defined(MAC)
   char prntscrnbuf[80];
@@ -1662,12 +1794,25 @@ void screen_map()
   priority['\''] = -3;
   priority[' '] = -15;
 
+  /* blindness and hallucination change every symbol on the level, and the
+     latter does so randomly on every call, so bypass the cache for them */
+  if ((py.flags.status & PY_BLIND) || py.flags.image > 0)
+    {
+      full = true;
+      ov_all_dirty = true;
+    }
+  else
+    {
+      full = ov_all_dirty;
+      ov_all_dirty = false;
+    }
+
   save_screen();
   clear_screen();
 #ifdef MAC
   DSetScreenCursor(0, 0);
   DWriteScreenCharAttr(CH(TL), ATTR_NORMAL);
-  for (i = 0; i < MAX_WIDTH / RATIO; i++)
+  for (i = 0; i < OV_WIDTH; i++)
     DWriteScreenCharAttr(CH(HE), ATTR_NORMAL);
   DWriteScreenCharAttr(CH(TR), ATTR_NORMAL);
 #else
@@ -1676,7 +1821,7 @@ void screen_map()
 # else
   use_value2 mvaddch(0, 0, CH(TL));
 # endif
-  for (i = 0; i < MAX_WIDTH / RATIO; i++)
+  for (i = 0; i < OV_WIDTH; i++)
 # if defined(PDC_WIDE)
     add_wch(&cp437utf[CH(HE)]);
   add_wch(&cp437utf[CH(TR)]);
@@ -1685,84 +1830,51 @@ void screen_map()
   (void) addch(CH(TR));
 # endif
 #endif
-  orow = -1;
-  map[MAX_WIDTH / RATIO] = '\0';
-  for (i = 0; i < MAX_HEIGHT; i++)
+  for (row = 0; row < OV_HEIGHT; row++)
   {
-    row = i / RATIO;
-    if (row != orow)
-    {
-      if (orow >= 0)
-      {
-#ifdef MAC
-        DSetScreenCursor(0, orow+1);
-        DWriteScreenCharAttr(CH(VE), ATTR_NORMAL);
-        DWriteScreenString((char *) map);
-        DWriteScreenCharAttr(CH(VE), ATTR_NORMAL);
-#elif defined(PDC_WIDE)
-        wprntscrnbuf[0] = cp437utf[CH(VE)];
-        for (k = 0; k < MAX_WIDTH / RATIO; ++k)
-          wprntscrnbuf[k + 1] = ToUTF(map[k]);
-        wprntscrnbuf[MAX_WIDTH / RATIO + 1] = cp437utf[CH(VE)];
-        wprntscrnbuf[MAX_WIDTH / RATIO + 2] = '\0';
-        mvaddwstr(orow + 1, 0, wprntscrnbuf);
-#else
-     /* can not use mvprintw() on ibmpc, because PC-Curses is horribly
-        written, and mvprintw() causes the fp emulation library to be
-        linked with PC-Moria, makes the program 10K bigger */
-        (void) sprintf(prntscrnbuf,"%c%s%c",CH(VE), map, CH(VE));
-        use_value2 mvaddstr(orow + 1, 0, prntscrnbuf);
-#endif
-      }
-      for (j = 0; j < MAX_WIDTH / RATIO; j++)
-        map[j] = ' ';
-      orow = row;
-    }
-    for (j = 0; j < MAX_WIDTH; j++)
+    map = ov_map[row];
+    for (col = 0; col < OV_WIDTH; col++)
     {
-      col = j / RATIO;
-      tmp = loc_symbol(i, j);
-      if (priority[map[col]] < priority[tmp])
-        map[col] = tmp;
+      if (full || ov_dirty[row][col])
+        screen_map_block(row, col, priority);
       if (map[col] == '@')
       {
         mycol = col + 1; /* account for border */
         myrow = row + 1;
       }
     }
-  }
-  if (orow >= 0)
-  {
 #ifdef MAC
-    DSetScreenCursor(0, orow+1);
+    DSetScreenCursor(0, row+1);
     DWriteScreenCharAttr(CH(VE), ATTR_NORMAL);
     DWriteScreenString((char *) map);
     DWriteScreenCharAttr(CH(VE), ATTR_NORMAL);
 #elif defined(PDC_WIDE)
     wprntscrnbuf[0] = cp437utf[CH(VE)];
-    for (k = 0; k < MAX_WIDTH / RATIO; ++k)
-      wprntscrnbuf[k+1] = ToUTF(map[k]);
-    wprntscrnbuf[MAX_WIDTH / RATIO + 1] = cp437utf[CH(VE)];
-    wprntscrnbuf[MAX_WIDTH / RATIO + 2] = '\0';
-    mvaddwstr(orow + 1, 0, wprntscrnbuf);
-#else
+    ToUTFRow(&wprntscrnbuf[1], map, OV_WIDTH);
+    wprntscrnbuf[OV_WIDTH + 1] = cp437utf[CH(VE)];
+    wprntscrnbuf[OV_WIDTH + 2] = '\0';
+    mvaddwstr(row + 1, 0, wprntscrnbuf);
+#else
+    /* can not use mvprintw() on ibmpc, because PC-Curses is horribly
+       written, and mvprintw() causes the fp emulation library to be
+       linked with PC-Moria, makes the program 10K bigger */
     (void) sprintf(prntscrnbuf,"%c%s%c",CH(VE), map, CH(VE));
-    use_value2 mvaddstr(orow + 1, 0, prntscrnbuf);
+    use_value2 mvaddstr(row + 1, 0, prntscrnbuf);
 #endif
   }
 #ifdef MAC
-  DSetScreenCursor(0, orow + 2);
+  DSetScreenCursor(0, OV_HEIGHT + 1);
   DWriteScreenCharAttr(CH(BL), ATTR_NORMAL);
-  for (i = 0; i < MAX_WIDTH / RATIO; i++)
+  for (i = 0; i < OV_WIDTH; i++)
     DWriteScreenCharAttr(CH(HE), ATTR_NORMAL);
   DWriteScreenCharAttr(CH(BR), ATTR_NORMAL);
 #else
 #if defined(PDC_WIDE)
-  mvadd_wch(orow + 2, 0, &cp437utf[CH(BL)]);
+  mvadd_wch(OV_HEIGHT + 1, 0, &cp437utf[CH(BL)]);
 #else
-  use_value2 mvaddch(orow + 2, 0, CH(BL));
+  use_value2 mvaddch(OV_HEIGHT + 1, 0, CH(BL));
 #endif
-  for (i = 0; i < MAX_WIDTH / RATIO; i++)
+  for (i = 0; i < OV_WIDTH; i++)
 #if defined(PDC_WIDE)
     add_wch(&cp437utf[CH(HE)]);
   add_wch(&cp437utf[CH(BR)]);
@@ -0,0 +1,433 @@
+/* source/journal.c: write-ahead command journal for crash recovery
+
+   When play starts, the game is checkpointed to the savefile, and a journal
+   is started next to it holding the random number generator seed as of the
+   checkpoint, and the size of the map view, which decides how much of the
+   level the character can see and detect.  From then on every key the
+   player types, and every outside event that can change the course of the
+   game (a key press interrupting a rest or run, the game hours running
+   out, the end of input), is appended to the journal.
+   Since everything else the game does follows from the savefile, the seed
+   and those inputs, restarting after a crash restores the checkpoint and
+   replays the journal, which brings the game back to exactly where it was.
+
+   Records are single bytes holding a key, except that JOURNAL_ESC
+   introduces a longer record: JOURNAL_ESC again for a literal JOURNAL_ESC
+   key, or the number of an event followed by the four byte game turn it
+   happened in.  A rest, run or repeated command checks for an interruption
+   every turn without reading any keys, so the position of the record alone
+   does not say which of those turns it happened in.  Records are written
+   in batches of up to JOURNAL_BATCH bytes, straight to a file descriptor,
+   so that the signal handler can safely push out the last batch before the
+   game dies.
+
+   A crash that follows from the journal would happen again every time the
+   journal is replayed, so the signal handler ends the journal with a
+   JE_CRASH record giving the offset of the command the game crashed in.
+   When the journal is loaded, that command and the record are cut out, so
+   the recovered game stops just before it.  If the game crashes while the
+   journal is still being replayed, a JE_REPLAY_CRASH record is written
+   instead, and the next restart gives up on the journal and carries on
+   from the checkpoint.
+
+   The journal is discarded when the session ends normally, i.e. when the
+   character is saved or dies. */
+
+#include "config.h"
+#include "types.h"
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* This must be included after fcntl.h, which has a prototype for `open'
+   on some systems.  Otherwise, the `open' prototype conflicts with the
+   `topen' declaration.  */
+#include "externs.h"
+
+#ifndef O_BINARY
+# define O_BINARY 0
+#endif
+
+#define JOURNAL_MAGIC       "HZMJRNL3"
+#define JOURNAL_MAGIC_SIZE  8
+#define JOURNAL_HEADER_SIZE (JOURNAL_MAGIC_SIZE + 4 + 4 + 4 + 4)
+#define JOURNAL_ESC         0xFF
+#define JOURNAL_BATCH       128
+
+static int jnl_fd = -1;
+static int8u jnl_buf[JOURNAL_BATCH + 2];
+static int jnl_len = 0;
+/* bytes in the journal file, and the offset in it at which the command
+   being carried out started, or -1 if not known */
+static long jnl_file_len = 0;
+static long jnl_cmd_start = -1;
+/* while replaying, where in the journal the last command started */
+static long jnl_cmd_replay_pos = -1;
+/* set when the journal was given up on after a crash during replay */
+static bool jnl_abandoned = false;
+/* journal being replayed, and the read position within it */
+static int8u *jnl_replay = NULL;
+static long jnl_replay_len, jnl_replay_pos;
+
+static void jnl_name(char *const buf)
+{
+  (void) sprintf(buf, "%s.jnl", savefile);
+}
+
+static void jnl_put32(int8u *const p, const int32u v)
+{
+  p[0] = (int8u)(v & 0xFF);
+  p[1] = (int8u)((v >> 8) & 0xFF);
+  p[2] = (int8u)((v >> 16) & 0xFF);
+  p[3] = (int8u)((v >> 24) & 0xFF);
+}
+
+static int32u jnl_get32(int8u const *const p)
+{
+  return (int32u)p[0] | ((int32u)p[1] << 8) | ((int32u)p[2] << 16)
+       | ((int32u)p[3] << 24);
+}
+
+/* Cut the commands the game crashed in out of a journal that has been
+   read in, returning its new length, or -1 if the game crashed while the
+   journal was being replayed.  A damaged crash record ends the journal. */
+static long jnl_cut_crashes(int8u *const buf, const long len)
+{
+  long pos = JOURNAL_HEADER_SIZE, out = JOURNAL_HEADER_SIZE;
+  /* bytes cut so far, and the file offset just past the last crash */
+  long cut = 0, last = JOURNAL_HEADER_SIZE;
+  long start;
+
+  while (pos < len)
+  {
+    if (buf[pos] != JOURNAL_ESC || pos + 1 >= len)
+      buf[out++] = buf[pos++];
+    else if (buf[pos + 1] == JE_REPLAY_CRASH)
+      return -1;
+    else if (buf[pos + 1] == JOURNAL_ESC)
+    {
+      buf[out++] = buf[pos++];
+      buf[out++] = buf[pos++];
+    }
+    else if (buf[pos + 1] != JE_CRASH)
+    {
+      /* copy the turn too, since it may contain JOURNAL_ESC */
+      if (pos + 6 > len) break;
+      memcpy(&buf[out], &buf[pos], 6);
+      out += 6;
+      pos += 6;
+    }
+    else
+    {
+      if (pos + 6 > len) break;
+      start = (long)jnl_get32(&buf[pos + 2]);
+      if (start < last || start > pos) break;
+      out = start - cut;
+      pos += 6;
+      cut += pos - start;
+      last = pos;
+    }
+  }
+  return out;
+}
+
+/* Read the journal for the current savefile, returning its length, or -1
+   if there is none, it does not belong to the game that was restored, or
+   it has been given up on.  If buf is not NULL, the journal is left in a
+   newly allocated buffer, with any commands the game crashed in cut out. */
+static long jnl_load(int8u **const buf)
+{
+  bigvtype name;
+  int8u hdr[JOURNAL_HEADER_SIZE];
+  int8u *data = NULL;
+  FILE *fp;
+  long len = -1;
+
+  jnl_name(name);
+  if ((fp = fopen(name, "rb")) == NULL) return -1;
+  if (fread(hdr, 1, JOURNAL_HEADER_SIZE, fp) == JOURNAL_HEADER_SIZE
+      && memcmp(hdr, JOURNAL_MAGIC, JOURNAL_MAGIC_SIZE) == 0
+      && jnl_get32(&hdr[JOURNAL_MAGIC_SIZE + 4]) == (int32u)turn
+      && jnl_get32(&hdr[JOURNAL_MAGIC_SIZE + 8]) == (int32u)birth_date
+      && fseek(fp, 0L, SEEK_END) == 0)
+  {
+    len = ftell(fp);
+    if (len <= 0
+        || (data = (int8u *)malloc((size_t)len)) == NULL
+        || fseek(fp, 0L, SEEK_SET) != 0
+        || fread(data, 1, (size_t)len, fp) != (size_t)len)
+    {
+      len = -1;
+    }
+    else
+    {
+      jnl_file_len = len;
+      len = jnl_cut_crashes(data, len);
+      jnl_abandoned = (len < 0);
+    }
+  }
+  (void) fclose(fp);
+  if (buf != NULL && len >= 0) *buf = data;
+  else free(data);
+  return len;
+}
+
+/* Add a record, writing out the batch once it is full */
+static void jnl_put(const int8u a, const int8u b, const bool pair)
+{
+  if (jnl_fd < 0) return;
+  jnl_buf[jnl_len++] = a;
+  if (pair) jnl_buf[jnl_len++] = b;
+  if (jnl_len >= JOURNAL_BATCH) (void) journal_sync();
+}
+
+/* Stop replaying, and carry on recording after what was replayed. If the
+   journal was damaged, anything recorded after the damage will not be
+   replayed next time, but the checkpoint and everything before it are
+   still good. */
+static void jnl_replay_done()
+{
+  /* the command being read carries on in what is typed next, unless some
+     of it was replayed, in which case it can not be cut out later */
+  if (jnl_replay != NULL && jnl_cmd_replay_pos == jnl_replay_pos)
+    jnl_cmd_start = jnl_file_len + jnl_len;
+  else
+    jnl_cmd_start = -1;
+  free(jnl_replay);
+  jnl_replay = NULL;
+}
+
+/* Returns true if the savefile just restored has a journal to replay */
+bool journal_pending()
+{
+  return jnl_load(NULL) > JOURNAL_HEADER_SIZE;
+}
+
+/* Called when play is about to begin. If there is a journal for the game
+   just restored, start replaying it; otherwise checkpoint the game and
+   start a new journal. */
+void journal_start()
+{
+  bigvtype name;
+  int8u hdr[JOURNAL_HEADER_SIZE];
+  long len;
+  int32u view;
+
+  /* any pending -more- must be dealt with now, so that message handling
+     is in the same state whether we are replaying or not */
+  msg_print(CNIL);
+
+  jnl_name(name);
+  len = jnl_load(&jnl_replay);
+  if (len > JOURNAL_HEADER_SIZE)
+  {
+    view = jnl_get32(&jnl_replay[JOURNAL_MAGIC_SIZE + 12]);
+    if ((int)(view >> 16) != view_height || (int)(view & 0xFFFF) != view_width)
+    {
+      /* leave the journal alone, so that it can still be replayed on a
+         screen big enough for it */
+      if (!set_view((int)(view >> 16), (int)(view & 0xFFFF)))
+      {
+        restore_term();
+        (void) printf("Screen too small to recover this game (need %dx%d).\n",
+                      (int)(view & 0xFFFF) + 13, (int)(view >> 16) + 2);
+        exit(1);
+      }
+      clear_screen();
+      prt_stat_block();
+    }
+    jnl_fd = open(name, O_WRONLY | O_APPEND | O_BINARY, 0644);
+    if (jnl_fd < 0)
+    {
+      jnl_replay_done();
+      return;
+    }
+    set_rnd_seed(jnl_get32(&jnl_replay[JOURNAL_MAGIC_SIZE]));
+    jnl_replay_len = len;
+    jnl_replay_pos = JOURNAL_HEADER_SIZE;
+    return;
+  }
+  if (jnl_replay != NULL) jnl_replay_done();
+  if (jnl_abandoned)
+  {
+    msg_print("The game crashed again while it was being recovered.");
+    msg_print("Carrying on from where it was last saved.");
+    msg_print(CNIL);
+    jnl_abandoned = false;
+  }
+
+  /* without a checkpoint to replay from, or a journal to replay, a crash
+     would lose the session, so the player must be told */
+  if (!checkpoint_char())
+  {
+    msg_print("Couldn't save the game; it can't be recovered if it "
+              "crashes.");
+    return;
+  }
+  jnl_fd = open(name, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+  if (jnl_fd < 0)
+  {
+    msg_print("Couldn't create the journal; the game can't be recovered "
+              "if it crashes.");
+    return;
+  }
+  memcpy(hdr, JOURNAL_MAGIC, JOURNAL_MAGIC_SIZE);
+  /* set_rnd_seed() adds one to bring its argument into range */
+  jnl_put32(&hdr[JOURNAL_MAGIC_SIZE], get_rnd_seed() - 1);
+  jnl_put32(&hdr[JOURNAL_MAGIC_SIZE + 4], (int32u)turn);
+  jnl_put32(&hdr[JOURNAL_MAGIC_SIZE + 8], (int32u)birth_date);
+  jnl_put32(&hdr[JOURNAL_MAGIC_SIZE + 12],
+            ((int32u)view_height << 16) | (int32u)view_width);
+  if (write(jnl_fd, hdr, JOURNAL_HEADER_SIZE) != JOURNAL_HEADER_SIZE)
+  {
+    (void) close(jnl_fd);
+    jnl_fd = -1;
+    (void) unlink(name);
+    msg_print("Couldn't write the journal; the game can't be recovered "
+              "if it crashes.");
+  }
+  jnl_file_len = JOURNAL_HEADER_SIZE;
+  jnl_cmd_start = -1;
+}
+
+/* Returns true while the journal is being replayed */
+bool journal_replaying()
+{
+  return jnl_replay != NULL;
+}
+
+/* Note that the game is about to read the first key of a new command */
+void journal_command()
+{
+  if (jnl_replay != NULL)
+    jnl_cmd_replay_pos = jnl_replay_pos;
+  else if (jnl_fd >= 0)
+    jnl_cmd_start = jnl_file_len + jnl_len;
+}
+
+/* Record a key the player typed */
+void journal_key(const char ch)
+{
+  if ((int8u)ch == JOURNAL_ESC) jnl_put(JOURNAL_ESC, JOURNAL_ESC, true);
+  else                          jnl_put((int8u)ch, 0, false);
+}
+
+/* While replaying, fetch the next key the player typed. Returns false if
+   the journal has run out, after which input comes from the keyboard. */
+bool journal_replay_key(char *const ch)
+{
+  if (jnl_replay == NULL) return false;
+  if (jnl_replay_pos >= jnl_replay_len)
+  {
+    jnl_replay_done();
+    return false;
+  }
+  if (jnl_replay[jnl_replay_pos] == JOURNAL_ESC)
+  {
+    /* an event where a key is expected means the journal is damaged */
+    if (jnl_replay_pos + 1 >= jnl_replay_len
+        || jnl_replay[jnl_replay_pos + 1] != JOURNAL_ESC)
+    {
+      jnl_replay_done();
+      return false;
+    }
+    jnl_replay_pos++;
+  }
+  *ch = (char)jnl_replay[jnl_replay_pos++];
+  return true;
+}
+
+/* Outside events are checked for by calling this with the live result of
+   the check. Normally, that result is recorded if the event happened, and
+   returned. While replaying, the live result is ignored, and whether the
+   event happened at this point in the original game is returned. */
+bool journal_event(const int event, const bool happened)
+{
+  int8u t[4];
+
+  jnl_put32(t, (int32u)turn);
+  if (jnl_replay == NULL)
+  {
+    if (happened)
+    {
+      jnl_put(JOURNAL_ESC, (int8u)event, true);
+      jnl_put(t[0], t[1], true);
+      jnl_put(t[2], t[3], true);
+    }
+    return happened;
+  }
+  if (jnl_replay_pos >= jnl_replay_len)
+  {
+    jnl_replay_done();
+    return false;
+  }
+  if (jnl_replay[jnl_replay_pos] != JOURNAL_ESC
+      || jnl_replay_pos + 6 > jnl_replay_len
+      || jnl_replay[jnl_replay_pos + 1] != (int8u)event
+      || memcmp(&jnl_replay[jnl_replay_pos + 2], t, 4) != 0)
+  {
+    return false;
+  }
+  jnl_replay_pos += 6;
+  return true;
+}
+
+/* Write out the current batch. Only uses write(), so this is safe to call
+   from a signal handler. Returns true if there is a journal and it is now
+   completely on disk. */
+bool journal_sync()
+{
+  int n = jnl_len;
+
+  if (jnl_fd < 0) return false;
+  jnl_len = 0;
+  if (n == 0) return true;
+  if (write(jnl_fd, jnl_buf, n) != n) return false;
+  jnl_file_len += n;
+  return true;
+}
+
+/* Called by the signal handler when the game crashes, to mark the command
+   it crashed in, so that replaying the journal stops short of it. Only
+   uses write(), and returns as journal_sync() does. */
+bool journal_crash()
+{
+  int8u off[4];
+
+  if (jnl_fd < 0) return false;
+  if (jnl_replay != NULL || jnl_cmd_start < 0)
+    jnl_put(JOURNAL_ESC, JE_REPLAY_CRASH, true);
+  else
+  {
+    jnl_put32(off, (int32u)jnl_cmd_start);
+    jnl_put(JOURNAL_ESC, JE_CRASH, true);
+    jnl_put(off[0], off[1], true);
+    jnl_put(off[2], off[3], true);
+  }
+  return journal_sync();
+}
+
+/* End the session's journal: it is no longer needed if the character has
+   been saved or has died, otherwise keep it for the next restart */
+void journal_close()
+{
+  bigvtype name;
+
+  if (jnl_fd < 0) return;
+  (void) journal_sync();
+  (void) close(jnl_fd);
+  jnl_fd = -1;
+  if (character_saved || death)
+  {
+    jnl_name(name);
+    (void) unlink(name);
+  }
+}
@@ -29,7 +29,7 @@ void cast()
   register struct flags *f_ptr;
   register struct misc *p_ptr;
   register inven_type *i_ptr;
-  register spell_type *m_ptr;
+  register spell_type const *m_ptr;
 #ifdef ATARIST_MWC
   int32u holder;
 #endif
@@ -166,18 +166,8 @@ char * NEAR _procname = "Moria";
 
 #if defined(LINT_ARGS)
 static void char_inven_init(void);
-static void init_m_level(void);
-static void init_t_level(void);
-#if (COST_ADJ != 100)
-static void price_adjust(void);
-#endif
 #else
 static void char_inven_init();
-static void init_m_level();
-static void init_t_level();
-#if (COST_ADJ != 100)
-static void price_adjust();
-#endif
 #endif
 
 /* Initialize, restore, and get the ball rolling.	-RAK-	*/
@@ -215,6 +205,12 @@ char *argv[];
   msdos_init();		/* find out where everything is */
 #endif
 
+#ifndef MAC
+  /* Spectator mode: follow somebody else's game instead of playing one */
+  if (argc == 3 && (!strcmp(argv[1], "-v") || !strcmp(argv[1], "-V")))
+    exit(spectate_view(argv[2]));
+#endif
+
   /* call this routine to grab a file pointer to the highscore file */
   /* and prepare things to relinquish setuid privileges */
   init_scorefile();
@@ -241,6 +237,17 @@ char *argv[];
   /* use curses */
   init_curses();
 
+#ifndef MAC
+  /* record the session and broadcast the screen to spectators, if asked
+     to */
+  record_init();
+  spectate_init();
+#endif
+  /* log gameplay events, if asked to */
+  event_init();
+  /* pick up the animation speed */
+  anim_init();
+
 #ifdef VMS
   /* Bizarre, but yes this really is needed to make moria work correctly
      under VMS.  */
@@ -280,7 +287,8 @@ char *argv[];
 	if (isdigit((int)argv[0][2]))
 	  seed = atoi(&argv[0][2]);
 	break;
-      default: (void) printf("Usage: moria [-norsw] [savefile]\n");
+      default: (void) printf("Usage: moria [-norsw] [savefile]\n"
+			     "       moria -v spectatefile\n");
 	exit_game();
 #endif
       }
@@ -294,17 +302,9 @@ char *argv[];
   /* Some necessary initializations		*/
   /* all made into constants or initialized in variables.c */
 
-#if (COST_ADJ != 100)
-  price_adjust();
-#endif
-
   /* Grab a random seed from the clock		*/
   init_seeds(seed);
 
-  /* Init monster and treasure levels for allocate */
-  init_m_level();
-  init_t_level();
-
   /* Init the store inventories			*/
   store_init();
 
@@ -396,6 +396,9 @@ char *argv[];
   if (generate)
     generate_cave();
 
+  /* from here on the game can be recovered after a crash */
+  journal_start();
+
   /* Loop till dead, or exit			*/
   while(!death)
     {
@@ -416,7 +419,11 @@ char *argv[];
 	}
 #endif
 
-      if (!death) generate_cave();	       /* New level	*/
+      if (!death)
+	{
+	  event_log(EV_LEVEL, CNIL, (int32)dun_level);
+	  generate_cave();	       /* New level	*/
+	}
     }
 
   exit_game();		/* Character gets buried. */
@@ -450,70 +457,3 @@ static void char_inven_init()
   for (i = 0; i < 32; i++)
     spell_order[i] = 99;
 }
-
-
-/* Initializes M_LEVEL array for use with PLACE_MONSTER	-RAK-	*/
-static void init_m_level()
-{
-  register int i, k;
-
-  for (i = 0; i <= MAX_MONS_LEVEL; i++)
-    m_level[i] = 0;
-
-  k = MAX_CREATURES - WIN_MON_TOT;
-  for (i = 0; i < k; i++)
-    m_level[c_list[i].level]++;
-
-  for (i = 1; i <= MAX_MONS_LEVEL; i++)
-#if defined(AMIGA) && !defined(LATTICE)
-    /* fix a stupid MANX Aztec C 5.0 bug again */
-    m_level[i] = m_level[i] + m_level[i-1];
-#else
-    m_level[i] += m_level[i-1];
-#endif
-}
-
-
-/* Initializes T_LEVEL array for use with PLACE_OBJECT	-RAK-	*/
-static void init_t_level()
-{
-  register int i, l;
-  int tmp[MAX_OBJ_LEVEL+1];
-
-  for (i = 0; i <= MAX_OBJ_LEVEL; i++)
-    t_level[i] = 0;
-  for (i = 0; i < MAX_DUNGEON_OBJ; i++)
-    t_level[object_list[i].level]++;
-  for (i = 1; i <= MAX_OBJ_LEVEL; i++)
-#if defined(AMIGA) && !defined(LATTICE)
-    /* fix a stupid MANX Aztec C 5.0 bug again */
-    t_level[i] = t_level[i] + t_level[i-1];
-#else
-    t_level[i] += t_level[i-1];
-#endif
-
-  /* now produce an array with object indexes sorted by level, by using
-     the info in t_level, this is an O(n) sort! */
-  /* this is not a stable sort, but that does not matter */
-  for (i = 0; i <= MAX_OBJ_LEVEL; i++)
-    tmp[i] = 1;
-  for (i = 0; i < MAX_DUNGEON_OBJ; i++)
-    {
-      l = object_list[i].level;
-      sorted_objects[t_level[l] - tmp[l]] = i;
-      tmp[l]++;
-    }
-}
-
-
-#if (COST_ADJ != 100)
-/* Adjust prices of objects				-RAK-	*/
-static void price_adjust()
-{
-  register int i;
-
-  /* round half-way cases up */
-  for (i = 0; i < MAX_OBJECTS; i++)
-    object_list[i].cost = ((object_list[i].cost * COST_ADJ) + 50) / 100;
-}
-#endif
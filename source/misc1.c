@@ -161,14 +161,36 @@ bool in_bounds(const int y, const int x)
        && (x > 0) && (x < cur_width  - 1));
 }
 
+/* Returns the last panel of a level size squares across, for a view
+   that is view squares across */
+static int panel_limit(const int size, const int view)
+{
+  if (size <= view) return 0;
+  /* the last panel may have to stop short of a whole half view */
+  return (size - view + view / 2 - 1) / (view / 2);
+}
+
+/* Gives the first and last squares of a panel of a level size squares
+   across, where the view is view squares across. A view that is larger
+   than the level shows all of it. */
+static void panel_span(const int panel, const int size, const int view,
+                       int *const min, int *const max)
+{
+  *min = panel * (view / 2);
+  if (*min > size - view) *min = size - view;
+  if (*min < 0) *min = 0;
+  *max = *min + view - 1;
+  if (*max >= size) *max = size - 1;
+}
+
 /* Calculates current boundaries -RAK- */
 void panel_bounds()
 {
-  panel_row_min = panel_row     * (SCREEN_HEIGHT / 2);
-  panel_row_max = panel_row_min + SCREEN_HEIGHT - 1;
+  panel_span(panel_row, cur_height, view_height,
+             &panel_row_min, &panel_row_max);
   panel_row_prt = panel_row_min - 1;
-  panel_col_min = panel_col     * (SCREEN_WIDTH / 2);
-  panel_col_max = panel_col_min + SCREEN_WIDTH - 1;
+  panel_span(panel_col, cur_width, view_width,
+             &panel_col_min, &panel_col_max);
   panel_col_prt = panel_col_min - 13;
 }
 
@@ -184,10 +206,10 @@ bool get_panel(const int y, const int x, const int force)
   pcol = panel_col;
   if (force || (y < panel_row_min + 2) || (y > panel_row_max - 2))
   {
-    prow = ((y - SCREEN_HEIGHT / 4) / (SCREEN_HEIGHT / 2));
-    if (prow > max_panel_rows)
+    prow = ((y - view_height / 4) / (view_height / 2));
+    if (prow > panel_limit(cur_height, view_height))
     {
-      prow = max_panel_rows;
+      prow = panel_limit(cur_height, view_height);
     }
     else if (prow < 0)
     {
@@ -196,10 +218,10 @@ bool get_panel(const int y, const int x, const int force)
   }
   if (force || (x < panel_col_min + 3) || (x > panel_col_max - 3))
   {
-    pcol = ((x - SCREEN_WIDTH / 4) / (SCREEN_WIDTH / 2));
-    if (pcol > max_panel_cols)
+    pcol = ((x - view_width / 4) / (view_width / 2));
+    if (pcol > panel_limit(cur_width, view_width))
     {
-      pcol = max_panel_cols;
+      pcol = panel_limit(cur_width, view_width);
     }
     else if (pcol < 0)
     {
@@ -307,8 +329,22 @@ int pdamroll(int8u const *const array)
    it only passes across one corner of that tile.
 
    Because this function uses (short) ints for all calculations, overflow
-   may occur if deltaX and deltaY exceed 90. */
-bool los(int fromY, int fromX, int toY, int toX)
+   may occur if deltaX and deltaY exceed 90.
+
+   The walk itself is shared with los_path(): when ys is not NULL, the
+   tiles passed through are recorded in ys/xs instead of being tested. */
+static bool los_tile(const int y, const int x, int *const ys, int *const xs,
+                     int *const len)
+{
+  if (ys == NULL) return cave[y][x].fval < MIN_CLOSED_SPACE;
+  ys[*len] = y;
+  xs[*len] = x;
+  (*len)++;
+  return true;
+}
+
+static bool los_walk(int fromY, int fromX, int toY, int toX,
+                     int *const ys, int *const xs, int *const len)
 {
   int tmp, deltaX, deltaY;
 
@@ -331,7 +367,7 @@ bool los(int fromY, int fromX, int toY, int toX)
     }
     for (p_y = fromY + 1; p_y < toY; p_y++)
     {
-      if (cave[p_y][fromX].fval >= MIN_CLOSED_SPACE) return false;
+      if (!los_tile(p_y, fromX, ys, xs, len)) return false;
     }
     return true;
   }
@@ -346,7 +382,7 @@ bool los(int fromY, int fromX, int toY, int toX)
     }
     for (px = fromX + 1; px < toX; px++)
     {
-      if (cave[fromY][px].fval >= MIN_CLOSED_SPACE) return false;
+      if (!los_tile(fromY, px, ys, xs, len)) return false;
     }
     return true;
   }
@@ -397,7 +433,7 @@ bool los(int fromY, int fromX, int toY, int toX)
 
       while (toX - px)
       {
-        if (cave[p_y][px].fval >= MIN_CLOSED_SPACE) return false;
+        if (!los_tile(p_y, px, ys, xs, len)) return false;
 
         dy += m;
         if (dy < scale2)
@@ -407,7 +443,7 @@ bool los(int fromY, int fromX, int toY, int toX)
         else if (dy > scale2)
         {
           p_y += ySign;
-          if (cave[p_y][px].fval >= MIN_CLOSED_SPACE) return false;
+          if (!los_tile(p_y, px, ys, xs, len)) return false;
           px += xSign;
           dy -= scale;
         }
@@ -440,7 +476,7 @@ bool los(int fromY, int fromX, int toY, int toX)
 
     while (toY - p_y)
     {
-      if (cave[p_y][px].fval >= MIN_CLOSED_SPACE) return false;
+      if (!los_tile(p_y, px, ys, xs, len)) return false;
       dx += m;
       if (dx < scale2)
       {
@@ -449,7 +485,7 @@ bool los(int fromY, int fromX, int toY, int toX)
       else if (dx > scale2)
       {
         px += xSign;
-        if (cave[p_y][px].fval >= MIN_CLOSED_SPACE) return false;
+        if (!los_tile(p_y, px, ys, xs, len)) return false;
         p_y += ySign;
         dx -= scale;
       }
@@ -464,6 +500,27 @@ bool los(int fromY, int fromX, int toY, int toX)
   return true;
 }
 
+bool los(int fromY, int fromX, int toY, int toX)
+{
+  bool seen;
+
+  PROF_ENTER(PROF_LOS);
+  seen = los_walk(fromY, fromX, toY, toX, NULL, NULL, NULL);
+  PROF_LEAVE(PROF_LOS);
+  return seen;
+}
+
+/* Lists the tiles that must be transparent for los() from 0,0 to dy,dx,
+   returning how many there are.  Since los() only depends on the offset
+   between its ends, the list can be computed once and moved about. */
+int los_path(const int dy, const int dx, int *const ys, int *const xs)
+{
+  int len = 0;
+
+  (void) los_walk(0, 0, dy, dx, ys, xs, &len);
+  return len;
+}
+
 /* Returns symbol for given row, column -RAK- */
 unsigned char loc_symbol(const int y, const int x)
 {
@@ -481,7 +538,7 @@ unsigned char loc_symbol(const int y, const int x)
   if ((cave_ptr->cptr > 1) && (m_list[cave_ptr->cptr].ml))
     return c_list[m_list[cave_ptr->cptr].mptr].cchar;
   /* unlit floor or hidden object - return blank */
-  if (!cave_ptr->pl && !cave_ptr->tl && !cave_ptr->fm)
+  if (!test_light(y, x))
     return ' ';
   /* visible object - return associated character */
   if ((cave_ptr->tptr != 0)
@@ -514,8 +571,10 @@ unsigned char loc_symbol(const int y, const int x)
 /* Tests a spot for light or field mark status -RAK- */
 bool test_light(const int y, const int x)
 {
-  cave_type *cave_ptr = &cave[y][x];
-  return (cave_ptr->pl || cave_ptr->tl || cave_ptr->fm);
+  const int64u bit = CAVE_BIT(x);
+  const int w = x >> 6;
+
+  return ((cave_pl[y][w] | cave_tl[y][w] | cave_fm[y][w]) & bit) != 0;
 }
 
 /* Prints the map of the dungeon -RAK-
@@ -530,6 +589,10 @@ void prt_map()
   int i, j, k;
   unsigned char tmp_char;
 
+  PROF_ENTER(PROF_PRT_MAP);
+  /* blanks are erased rather than printed, so let screen_map() know about
+     the whole panel */
+  screen_map_area(panel_row_min, panel_col_min, panel_row_max, panel_col_max);
   k = 0;
   for (i = panel_row_min; i <= panel_row_max; i++)  /* Top to bottom */
   {
@@ -541,6 +604,13 @@ void prt_map()
       if (tmp_char != ' ') print(tmp_char, i, j);
     }
   }
+  /* a level smaller than the view leaves the rest of the view blank */
+  while (k < view_height)
+  {
+    k++;
+    erase_line(k, 13);
+  }
+  PROF_LEAVE(PROF_PRT_MAP);
 }
 
 /* Compact monsters -RAK-
@@ -630,12 +700,23 @@ int max_hp(int8u const *const array)
   return(array[0] * array[1]);
 }
 
+/* Copy the creature fields read every turn into the monster */
+void cache_monster(monster_type *const mon_ptr)
+{
+  creature_type const *const ctl_ptr = &c_list[mon_ptr->mptr];
+
+  mon_ptr->aaf      = ctl_ptr->aaf;
+  mon_ptr->level    = ctl_ptr->level;
+  mon_ptr->cmove    = ctl_ptr->cmove;
+  mon_ptr->cdefense = ctl_ptr->cdefense;
+}
+
 /* Places a monster at given location -RAK- */
 bool place_monster(const int y, const int x, const int z, const int slp)
 {
   int cur_pos = popm();
   monster_type *mon_ptr = (cur_pos == -1) ? NULL : &m_list[cur_pos];
-  creature_type *ctl_ptr;
+  creature_type const *ctl_ptr;
 
   if (mon_ptr == NULL) return false;
   ctl_ptr = &c_list[z];
@@ -643,6 +724,7 @@ bool place_monster(const int y, const int x, const int z, const int slp)
   mon_ptr->fy      = y;
   mon_ptr->fx      = x;
   mon_ptr->mptr    = z;
+  cache_monster(mon_ptr);
   mon_ptr->hp      = (ctl_ptr->cdefense & CD_MAX_HP) ?
     max_hp(ctl_ptr->hd) : pdamroll(ctl_ptr->hd);
   /* the c_list speed value is 10 greater, so that it can be a int8u */
@@ -662,7 +744,7 @@ void place_win_monster()
 {
   int y, x, cur_pos;
   monster_type *mon_ptr;
-  creature_type *ctl_ptr;
+  creature_type const *ctl_ptr;
 
   if (total_winner) return;
 
@@ -671,7 +753,6 @@ void place_win_monster()
      this should never happen. */
   if (cur_pos == -1) abort();
   mon_ptr = &m_list[cur_pos];
-  ctl_ptr = &c_list[mon_ptr->mptr];
   do
   {
     y = randint(cur_height - 2);
@@ -683,6 +764,8 @@ void place_win_monster()
   mon_ptr->fy      = y;
   mon_ptr->fx      = x;
   mon_ptr->mptr    = randint(WIN_MON_TOT) - 1 + m_level[MAX_MONS_LEVEL];
+  ctl_ptr = &c_list[mon_ptr->mptr];
+  cache_monster(mon_ptr);
   mon_ptr->hp      = (ctl_ptr->cdefense & CD_MAX_HP) ?
     max_hp(ctl_ptr->hd) : pdamroll(ctl_ptr->hd);
   /* the c_list speed value is 10 greater, so that it can be a int8u */
@@ -832,6 +915,7 @@ static void compact_objects()
   int i, j, ctr = 0, cur_dis = 66, chance;
   cave_type *cave_ptr;
 
+  PROF_ENTER(PROF_COMPACT_OBJECTS);
   msg_print("Compacting objects...");
 
   while (ctr <= 0)
@@ -882,6 +966,78 @@ static void compact_objects()
   /* if exclusion radius shrank to within possible player view distance,
      local view needs to be redrawn in case something in it was deleted */
   if (cur_dis < 66) prt_map();
+  PROF_LEAVE(PROF_COMPACT_OBJECTS);
+}
+
+/* Sets or clears the flag for a rectangle of squares in a cave flag plane,
+   a word at a time, and tells screen_map() the area may have changed */
+void cave_fill(cave_plane plane, const int y1, const int x1, const int y2,
+               const int x2, const bool v)
+{
+  const int w1 = x1 >> 6, w2 = x2 >> 6;
+  int y, w;
+  int64u mask;
+
+  if (x1 > x2) return;
+  for (y = y1; y <= y2; y++)
+  {
+    for (w = w1; w <= w2; w++)
+    {
+      mask = ~(int64u)0;
+      if (w == w1) mask &= ~(int64u)0 << (x1 & 63);
+      if (w == w2) mask &= ~(int64u)0 >> (63 - (x2 & 63));
+      if (v) plane[y][w] |= mask;
+      else   plane[y][w] &= ~mask;
+    }
+  }
+  screen_map_area(y1, x1, y2, x2);
+}
+
+/* Sets the flag in plane for every square on or next to a floor square
+   within the given area, and clears it everywhere else.  The floor squares
+   are gathered into a plane first, so that spreading them out to their
+   neighbours takes a few shifts per word. */
+void cave_near_floor(cave_plane plane, const int y1, const int x1,
+                     const int y2, const int x2)
+{
+  static cave_plane floor;
+  int64u vert[CAVE_WORDS];
+  int y, x, w;
+
+  cave_fill(floor, 0, 0, MAX_HEIGHT - 1, MAX_WIDTH - 1, false);
+  for (y = y1; y <= y2; y++)
+  {
+    for (x = x1; x <= x2; x++)
+    {
+      if (in_bounds(y, x) && cave[y][x].fval <= MAX_CAVE_FLOOR)
+        cave_on(floor, y, x);
+    }
+  }
+  for (y = 0; y < MAX_HEIGHT; y++)
+  {
+    for (w = 0; w < CAVE_WORDS; w++)
+    {
+      vert[w] = floor[y][w];
+      if (y > 0) vert[w] |= floor[y - 1][w];
+      if (y < MAX_HEIGHT - 1) vert[w] |= floor[y + 1][w];
+    }
+    for (w = 0; w < CAVE_WORDS; w++)
+    {
+      plane[y][w] = vert[w] | (vert[w] << 1) | (vert[w] >> 1);
+      if (w > 0) plane[y][w] |= vert[w - 1] >> 63;
+      if (w < CAVE_WORDS - 1) plane[y][w] |= vert[w + 1] << 63;
+    }
+  }
+}
+
+/* Puts object i at the given location, remembering where it went so that
+   the objects on the level can be found without scanning the cave */
+void set_tptr(const int y, const int x, const dindex i)
+{
+  cave[y][x].tptr = i;
+  t_row[i] = (dcoord)y;
+  t_col[i] = (dcoord)x;
+  screen_map_spot(y, x);
 }
 
 /* Gives pointer to next free space -RAK- */
@@ -894,24 +1050,22 @@ int popt()
 /* Pushes a record back onto free space list. delete_object() should always
    be called instead, unless the object in question is not in the dungeon,
    e.g. in store1.c and files.c -RAK- */
-void pusht(const int8u x)
+void pusht(const dindex x)
 {
-  int i, j;
+  const int last = tcptr - 1;
 
-  if (x != tcptr - 1)
+  PROF_ENTER(PROF_PUSHT);
+  if (x != last)
   {
-    t_list[x] = t_list[tcptr - 1];
-    /* must change the tptr in the cave of the object just moved */
-    for (i = 0; i < cur_height; i++)
-    {
-      for (j = 0; j < cur_width; j++)
-      {
-        if (cave[i][j].tptr == tcptr - 1) cave[i][j].tptr = x;
-      }
-    }
+    t_list[x] = t_list[last];
+    /* must change the tptr in the cave of the object just moved; objects
+       that are not in the dungeon have no location to fix */
+    if (cave[t_row[last]][t_col[last]].tptr == last)
+      set_tptr(t_row[last], t_col[last], x);
   }
   tcptr--;
   invcopy(&t_list[tcptr], OBJ_NOTHING);
+  PROF_LEAVE(PROF_PUSHT);
 }
 
 /* Boolean : is object enchanted -RAK-
@@ -1033,6 +1033,9 @@ static struct opt_desc { char *o_prompt; int *o_var; } options[] = {
   { "Highlight and notice mineral seams",	&highlight_seams },
   { "Beep for invalid character",		&sound_beep_flag },
   { "Display rest/repeat counts",		&display_counts },
+  { "Skip missile and spell animations",	&skip_anim_flag },
+  { "Monsters follow you around obstacles",	&smart_path_flag },
+  { "Restock stores when you return to town",	&lazy_store_flag },
   { 0, 0 } };
 
 
@@ -46,6 +46,7 @@ static void prt_7lnum(char *, int32, int, int);
 static void prt_num(char *, int, int, int);
 static void prt_long(int32, int, int);
 static void prt_int(int, int, int);
+static int status_changed(int, int32);
 static void gain_level(void);
 #endif
 
@@ -54,6 +55,51 @@ static char *stat_names[] = { "STR : ", "INT : ", "WIS : ",
 #define BLANK_LENGTH	24
 static char blank_string[] = "                        ";
 
+/* The fields of the status display kept up to date by the prt_ routines
+   below.  Each remembers the value it last showed, so that a field is
+   only formatted and printed again when its value has changed; the screen
+   erasing routines in io.c call status_forget() for whatever they
+   erase.  */
+#define ST_STAT		0	/* one for each of the six stats */
+#define ST_LEV		6
+#define ST_EXP		7
+#define ST_MANA		8
+#define ST_MHP		9
+#define ST_CHP		10
+#define ST_AC		11
+#define ST_GOLD		12
+#define ST_HUNGER	13
+#define ST_BLIND	14
+#define ST_CONFUSED	15
+#define ST_AFRAID	16
+#define ST_POISONED	17
+#define ST_STATE	18
+#define ST_SPEED	19
+#define ST_STUDY	20
+#define ST_DEPTH	21
+#define ST_FIELDS	22
+
+#define ST_BOTTOM	0xFF	/* row of the fields on the status line */
+
+static struct status_field
+{
+  int8u row, col, len;		/* where the field is on the screen */
+  int8u valid;			/* whether shown is on the screen */
+  int32 shown;
+} status_fields[ST_FIELDS] = {
+  {6, STAT_COLUMN, 12, 0, 0}, {7, STAT_COLUMN, 12, 0, 0},
+  {8, STAT_COLUMN, 12, 0, 0}, {9, STAT_COLUMN, 12, 0, 0},
+  {10, STAT_COLUMN, 12, 0, 0}, {11, STAT_COLUMN, 12, 0, 0},
+  {13, STAT_COLUMN+6, 6, 0, 0}, {14, STAT_COLUMN+6, 7, 0, 0},
+  {15, STAT_COLUMN+6, 6, 0, 0}, {16, STAT_COLUMN+6, 6, 0, 0},
+  {17, STAT_COLUMN+6, 6, 0, 0}, {19, STAT_COLUMN+6, 6, 0, 0},
+  {20, STAT_COLUMN+6, 7, 0, 0},
+  {ST_BOTTOM, 0, 6, 0, 0}, {ST_BOTTOM, 7, 5, 0, 0}, {ST_BOTTOM, 13, 8, 0, 0},
+  {ST_BOTTOM, 22, 6, 0, 0}, {ST_BOTTOM, 29, 8, 0, 0},
+  {ST_BOTTOM, 38, 10, 0, 0}, {ST_BOTTOM, 49, 9, 0, 0},
+  {ST_BOTTOM, 59, 5, 0, 0}, {ST_BOTTOM, 65, 14, 0, 0}
+};
+
 
 /* Places a particular trap at location y, x		-RAK-	*/
 void place_trap(y, x, subval)
@@ -62,7 +108,7 @@ int y, x, subval;
   register int cur_pos;
 
   cur_pos = popt();
-  cave[y][x].tptr  = cur_pos;
+  set_tptr(y, x, cur_pos);
   invcopy(&t_list[cur_pos], OBJ_TRAP_LIST + subval);
 }
 
@@ -76,7 +122,7 @@ int y, x;
 
   cur_pos = popt();
   cave_ptr = &cave[y][x];
-  cave_ptr->tptr = cur_pos;
+  set_tptr(y, x, cur_pos);
   cave_ptr->fval = BLOCKED_FLOOR;
   invcopy(&t_list[cur_pos], OBJ_RUBBLE);
 }
@@ -100,7 +146,7 @@ int y, x;
     i += randint(dun_level+1);
   if (i >= MAX_GOLD)
     i = MAX_GOLD - 1;
-  cave[y][x].tptr = cur_pos;
+  set_tptr(y, x, cur_pos);
   invcopy(&t_list[cur_pos], OBJ_GOLD_LIST+i);
   t_ptr = &t_list[cur_pos];
   t_ptr->cost += (8L * (long)randint((int)t_ptr->cost)) + randint(8);
@@ -168,7 +214,7 @@ int y, x, must_be_small;
   register int cur_pos, tmp;
 
   cur_pos = popt();
-  cave[y][x].tptr = cur_pos;
+  set_tptr(y, x, cur_pos);
   /* split this line up to avoid a reported compiler bug */
   tmp = get_obj_num(dun_level, must_be_small);
   invcopy(&t_list[cur_pos], sorted_objects[tmp]);
@@ -261,12 +307,49 @@ char *out_val;
 }
 
 
+/* Forget what the status fields on rows row1 to row2 show from column col
+   onwards, because that part of the screen has been erased.  */
+void status_forget(row1, row2, col)
+int row1, row2, col;
+{
+  register struct status_field *s_ptr;
+  register int row;
+
+  for (s_ptr = &status_fields[0]; s_ptr < &status_fields[ST_FIELDS]; s_ptr++)
+    {
+      /* the status line moves with the size of the map view */
+      row = (s_ptr->row == ST_BOTTOM) ? STATUS_ROW : s_ptr->row;
+      if (row >= row1 && row <= row2 && s_ptr->col + s_ptr->len > col)
+	s_ptr->valid = false;
+    }
+}
+
+
+/* Returns true if field must be printed to show value, in which case the
+   caller is expected to print it.  */
+static int status_changed(field, value)
+int field;
+int32 value;
+{
+  register struct status_field *s_ptr;
+
+  s_ptr = &status_fields[field];
+  if (s_ptr->valid && s_ptr->shown == value)
+    return false;
+  s_ptr->valid = true;
+  s_ptr->shown = value;
+  return true;
+}
+
+
 /* Print character stat in given row, column		-RAK-	*/
 void prt_stat(stat)
 int stat;
 {
   stat_type out_val1;
 
+  if (!status_changed(ST_STAT + stat, (int32)py.stats.use_stat[stat]))
+    return;
   cnv_stat(py.stats.use_stat[stat], out_val1);
   put_buffer(stat_names[stat], 6+stat, STAT_COLUMN);
   put_buffer (out_val1, 6+stat, STAT_COLUMN+6);
@@ -454,42 +537,48 @@ void prt_title()
 /* Prints level						-RAK-	*/
 void prt_level()
 {
-  prt_int((int)py.misc.lev, 13, STAT_COLUMN+6);
+  if (status_changed(ST_LEV, (int32)py.misc.lev))
+    prt_int((int)py.misc.lev, 13, STAT_COLUMN+6);
 }
 
 
 /* Prints players current mana points.		 -RAK-	*/
 void prt_cmana()
 {
-  prt_int(py.misc.cmana, 15, STAT_COLUMN+6);
+  if (status_changed(ST_MANA, (int32)py.misc.cmana))
+    prt_int(py.misc.cmana, 15, STAT_COLUMN+6);
 }
 
 
 /* Prints Max hit points				-RAK-	*/
 void prt_mhp()
 {
-  prt_int(py.misc.mhp, 16, STAT_COLUMN+6);
+  if (status_changed(ST_MHP, (int32)py.misc.mhp))
+    prt_int(py.misc.mhp, 16, STAT_COLUMN+6);
 }
 
 
 /* Prints players current hit points			-RAK-	*/
 void prt_chp()
 {
-  prt_int(py.misc.chp, 17, STAT_COLUMN+6);
+  if (status_changed(ST_CHP, (int32)py.misc.chp))
+    prt_int(py.misc.chp, 17, STAT_COLUMN+6);
 }
 
 
 /* prints current AC					-RAK-	*/
 void prt_pac()
 {
-  prt_int(py.misc.dis_ac, 19, STAT_COLUMN+6);
+  if (status_changed(ST_AC, (int32)py.misc.dis_ac))
+    prt_int(py.misc.dis_ac, 19, STAT_COLUMN+6);
 }
 
 
 /* Prints current gold					-RAK-	*/
 void prt_gold()
 {
-  prt_long(py.misc.au, 20, STAT_COLUMN+6);
+  if (status_changed(ST_GOLD, py.misc.au))
+    prt_long(py.misc.au, 20, STAT_COLUMN+6);
 }
 
 
@@ -499,64 +588,79 @@ void prt_depth()
   vtype depths;
   register int depth;
 
+  if (!status_changed(ST_DEPTH, (int32)dun_level))
+    return;
   depth = dun_level*50;
   if (depth == 0)
     (void) strcpy(depths, "Town level");
   else
     (void) sprintf(depths, "%d feet", depth);
-  prt(depths, 23, 65);
+  /* blank the field by hand, prt() would make it be forgotten again */
+  put_buffer(&blank_string[BLANK_LENGTH-14], STATUS_ROW, 65);
+  put_buffer(depths, STATUS_ROW, 65);
 }
 
 
 /* Prints status of hunger				-RAK-	*/
 void prt_hunger()
 {
+  if (!status_changed(ST_HUNGER,
+		      (int32)((PY_WEAK|PY_HUNGRY) & py.flags.status)))
+    return;
   if (PY_WEAK & py.flags.status)
-    put_buffer("Weak  ", 23, 0);
+    put_buffer("Weak  ", STATUS_ROW, 0);
   else if (PY_HUNGRY & py.flags.status)
-    put_buffer("Hungry", 23, 0);
+    put_buffer("Hungry", STATUS_ROW, 0);
   else
-    put_buffer(&blank_string[BLANK_LENGTH-6], 23, 0);
+    put_buffer(&blank_string[BLANK_LENGTH-6], STATUS_ROW, 0);
 }
 
 
 /* Prints Blind status					-RAK-	*/
 void prt_blind()
 {
+  if (!status_changed(ST_BLIND, (int32)(PY_BLIND & py.flags.status)))
+    return;
   if (PY_BLIND & py.flags.status)
-    put_buffer("Blind", 23, 7);
+    put_buffer("Blind", STATUS_ROW, 7);
   else
-    put_buffer(&blank_string[BLANK_LENGTH-5], 23, 7);
+    put_buffer(&blank_string[BLANK_LENGTH-5], STATUS_ROW, 7);
 }
 
 
 /* Prints Confusion status				-RAK-	*/
 void prt_confused()
 {
+  if (!status_changed(ST_CONFUSED, (int32)(PY_CONFUSED & py.flags.status)))
+    return;
   if (PY_CONFUSED & py.flags.status)
-    put_buffer("Confused", 23, 13);
+    put_buffer("Confused", STATUS_ROW, 13);
   else
-    put_buffer(&blank_string[BLANK_LENGTH-8], 23, 13);
+    put_buffer(&blank_string[BLANK_LENGTH-8], STATUS_ROW, 13);
 }
 
 
 /* Prints Fear status					-RAK-	*/
 void prt_afraid()
 {
+  if (!status_changed(ST_AFRAID, (int32)(PY_FEAR & py.flags.status)))
+    return;
   if (PY_FEAR & py.flags.status)
-    put_buffer("Afraid", 23, 22);
+    put_buffer("Afraid", STATUS_ROW, 22);
   else
-    put_buffer(&blank_string[BLANK_LENGTH-6], 23, 22);
+    put_buffer(&blank_string[BLANK_LENGTH-6], STATUS_ROW, 22);
 }
 
 
 /* Prints Poisoned status				-RAK-	*/
 void prt_poisoned()
 {
+  if (!status_changed(ST_POISONED, (int32)(PY_POISONED & py.flags.status)))
+    return;
   if (PY_POISONED & py.flags.status)
-    put_buffer("Poisoned", 23, 29);
+    put_buffer("Poisoned", STATUS_ROW, 29);
   else
-    put_buffer(&blank_string[BLANK_LENGTH-8], 23, 29);
+    put_buffer(&blank_string[BLANK_LENGTH-8], STATUS_ROW, 29);
 }
 
 
@@ -564,6 +668,7 @@ void prt_poisoned()
 void prt_state()
 {
   char tmp[16];
+  register int32 state;
 #ifdef ATARIST_MWC
   int32u holder;
 #endif
@@ -573,37 +678,72 @@ void prt_state()
 #else
   py.flags.status &= ~PY_REPEAT;
 #endif
+  /* Work out what is to be shown as a number, so that nothing need be
+     formatted if it is already there.  The low three bits say which
+     message, bit 3 that "Search" is written over "Repeat", and the rest
+     hold the count.  */
   if (py.flags.paralysis > 1)
-    put_buffer ("Paralysed", 23, 38);
+    state = 1;
   else if (PY_REST & py.flags.status)
     {
       if (py.flags.rest < 0)
-	(void) strcpy (tmp, "Rest *");
+	state = 2;
       else if (display_counts)
-	(void) sprintf (tmp, "Rest %-5d", py.flags.rest);
+	state = 3 + ((int32)py.flags.rest << 4);
       else
-	(void) strcpy (tmp, "Rest");
-      put_buffer (tmp, 23, 38);
+	state = 4;
     }
   else if (command_count > 0)
     {
       if (display_counts)
-	(void) sprintf (tmp, "Repeat %-3d", command_count);
+	state = 5 + ((int32)command_count << 4);
       else
-	(void) strcpy (tmp, "Repeat");
+	state = 6;
 #ifdef ATARIST_MWC
       py.flags.status |= holder;
 #else
       py.flags.status |= PY_REPEAT;
 #endif
-      put_buffer (tmp, 23, 38);
       if (PY_SEARCH & py.flags.status)
-	put_buffer ("Search", 23, 38);
+	state |= 8;
     }
   else if (PY_SEARCH & py.flags.status)
-    put_buffer("Searching", 23, 38);
-  else		/* "repeat 999" is 10 characters */
-    put_buffer(&blank_string[BLANK_LENGTH-10], 23, 38);
+    state = 7;
+  else
+    state = 0;
+  if (!status_changed(ST_STATE, state))
+    return;
+
+  switch ((int)(state & 7))
+    {
+    case 1:
+      put_buffer ("Paralysed", STATUS_ROW, 38);
+      break;
+    case 2: case 3: case 4:
+      if (state == 2)
+	(void) strcpy (tmp, "Rest *");
+      else if (state == 4)
+	(void) strcpy (tmp, "Rest");
+      else
+	(void) sprintf (tmp, "Rest %-5d", py.flags.rest);
+      put_buffer (tmp, STATUS_ROW, 38);
+      break;
+    case 5: case 6:
+      if ((state & 7) == 5)
+	(void) sprintf (tmp, "Repeat %-3d", command_count);
+      else
+	(void) strcpy (tmp, "Repeat");
+      put_buffer (tmp, STATUS_ROW, 38);
+      if (state & 8)
+	put_buffer ("Search", STATUS_ROW, 38);
+      break;
+    case 7:
+      put_buffer("Searching", STATUS_ROW, 38);
+      break;
+    default:	/* "repeat 999" is 10 characters */
+      put_buffer(&blank_string[BLANK_LENGTH-10], STATUS_ROW, 38);
+      break;
+    }
 }
 
 
@@ -615,16 +755,18 @@ void prt_speed ()
   i = py.flags.speed;
   if (PY_SEARCH & py.flags.status)   /* Search mode. */
     i--;
+  if (!status_changed(ST_SPEED, (int32)i))
+    return;
   if (i > 1)
-    put_buffer ("Very Slow", 23, 49);
+    put_buffer ("Very Slow", STATUS_ROW, 49);
   else if (i == 1)
-    put_buffer ("Slow     ", 23, 49);
+    put_buffer ("Slow     ", STATUS_ROW, 49);
   else if (i == 0)
-    put_buffer (&blank_string[BLANK_LENGTH-9], 23, 49);
+    put_buffer (&blank_string[BLANK_LENGTH-9], STATUS_ROW, 49);
   else if (i == -1)
-    put_buffer ("Fast     ", 23, 49);
+    put_buffer ("Fast     ", STATUS_ROW, 49);
   else
-    put_buffer ("Very Fast", 23, 49);
+    put_buffer ("Very Fast", STATUS_ROW, 49);
 }
 
 
@@ -639,10 +781,12 @@ void prt_study()
 #else
   py.flags.status &= ~PY_STUDY;
 #endif
+  if (!status_changed(ST_STUDY, (int32)(py.flags.new_spells != 0)))
+    return;
   if (py.flags.new_spells == 0)
-    put_buffer (&blank_string[BLANK_LENGTH-5], 23, 59);
+    put_buffer (&blank_string[BLANK_LENGTH-5], STATUS_ROW, 59);
   else
-    put_buffer ("Study", 23, 59);
+    put_buffer ("Study", STATUS_ROW, 59);
 }
 
 
@@ -929,6 +1073,8 @@ void prt_stat_block()
   register struct misc *m_ptr;
   register int i;
 
+  /* everything is printed again, whatever was there before */
+  status_forget(0, STATUS_ROW, 0);
   m_ptr = &py.misc;
   prt_field(race[py.misc.prace].trace,	  2, STAT_COLUMN);
   prt_field(class[py.misc.pclass].title,  3, STAT_COLUMN);
@@ -942,6 +1088,13 @@ void prt_stat_block()
   prt_num ("CHP ", m_ptr->chp,	 17, STAT_COLUMN);
   prt_num ("AC  ", m_ptr->dis_ac,      19, STAT_COLUMN);
   prt_lnum("GOLD", m_ptr->au,	       20, STAT_COLUMN);
+  (void) status_changed(ST_LEV, (int32)m_ptr->lev);
+  (void) status_changed(ST_EXP, m_ptr->exp);
+  (void) status_changed(ST_MANA, (int32)m_ptr->cmana);
+  (void) status_changed(ST_MHP, (int32)m_ptr->mhp);
+  (void) status_changed(ST_CHP, (int32)m_ptr->chp);
+  (void) status_changed(ST_AC, (int32)m_ptr->dis_ac);
+  (void) status_changed(ST_GOLD, m_ptr->au);
   prt_winner();
   status = py.flags.status;
   if ((PY_HUNGRY|PY_WEAK) & status)
@@ -969,6 +1122,7 @@ void draw_cave()
 {
   clear_screen ();
   prt_stat_block();
+  screen_map_reset();
   prt_map();
   prt_depth();
 }
@@ -1267,7 +1421,7 @@ register int item_val, drop_all;
   i = popt ();
   i_ptr = &inventory[item_val];
   t_list[i] = *i_ptr;
-  cave[char_row][char_col].tptr = i;
+  set_tptr(char_row, char_col, i);
 
   if (item_val >= INVEN_WIELD)
     takeoff (item_val, -1);
@@ -1482,7 +1636,7 @@ register inven_type *i_ptr;
 int spell_chance(spell)
 int spell;
 {
-  register spell_type *s_ptr;
+  register spell_type const *s_ptr;
   register int chance;
   register int stat;
 
@@ -1513,7 +1667,7 @@ int comment, nonconsec;
 {
   register int i, j;
   vtype out_val;
-  register spell_type *s_ptr;
+  register spell_type const *s_ptr;
   int col, offset;
   char *p;
   char spell_char;
@@ -1566,7 +1720,7 @@ register int *sn, *sc;
 char *prompt;
 int first_spell;
 {
-  register spell_type *s_ptr;
+  register spell_type const *s_ptr;
   int flag, redraw, offset, i;
   char choice;
   vtype out_str, tmp_str;
@@ -1661,7 +1815,7 @@ int stat;
   vtype tmp_str;
   char *p;
   register struct misc *p_ptr;
-  register spell_type *msp_ptr;
+  register spell_type const *msp_ptr;
 
   p_ptr = &py.misc;
   msp_ptr = &magic_spell[p_ptr->pclass-1][0];
@@ -1813,7 +1967,7 @@ void gain_spells()
   register int32u spell_flag, mask;
   vtype tmp_str;
   struct misc *p_ptr;
-  register spell_type *msp_ptr;
+  register spell_type const *msp_ptr;
 
   /* Priests don't need light because they get spells from their god,
      so only fail when can't see if player has MAGE spells.  This check
@@ -2031,7 +2185,7 @@ static void gain_level()
   register int32 dif_exp, need_exp;
   vtype out_val;
   register struct misc *p_ptr;
-  register class_type *c_ptr;
+  register class_type const *c_ptr;
 
   p_ptr = &py.misc;
   p_ptr->lev++;
@@ -2077,7 +2231,8 @@ void prt_experience()
   if (p_ptr->exp > p_ptr->max_exp)
     p_ptr->max_exp = p_ptr->exp;
 
-  prt_long(p_ptr->exp, 14, STAT_COLUMN+6);
+  if (status_changed(ST_EXP, p_ptr->exp))
+    prt_long(p_ptr->exp, 14, STAT_COLUMN+6);
 }
 
 
@@ -2318,7 +2473,7 @@ register inven_type *i_ptr;
 register int tdam;
 int monster;
 {
-  register creature_type *m_ptr;
+  register creature_type const *m_ptr;
   register recall_type *r_ptr;
 #ifdef ATARIST_MWC
   int32u holder;
@@ -2569,7 +2724,7 @@ int dis;
   for (i = char_row-1; i <= char_row+1; i++)
     for (j = char_col-1; j <= char_col+1; j++)
       {
-	cave[i][j].tl = false;
+	cave_off(cave_tl, i, j);
 	lite_spot(i, j);
       }
   lite_spot(char_row, char_col);
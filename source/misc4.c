@@ -88,7 +88,7 @@ char *str;
 void check_view()
 {
   register int i, j;
-  register cave_type *c_ptr, *d_ptr;
+  register cave_type *c_ptr;
 
   c_ptr = &cave[char_row][char_col];
   /* Check for new panel		   */
@@ -99,17 +99,16 @@ void check_view()
   /* A room of light should be lit.	 */
   if (c_ptr->fval == LIGHT_FLOOR)
     {
-      if ((py.flags.blind < 1) && !c_ptr->pl)
+      if ((py.flags.blind < 1) && !cave_flag(cave_pl, char_row, char_col))
 	light_room(char_row, char_col);
     }
   /* In doorway of light-room?		   */
-  else if (c_ptr->lr && (py.flags.blind < 1))
+  else if (cave_flag(cave_lr, char_row, char_col) && (py.flags.blind < 1))
     {
       for (i = (char_row - 1); i <= (char_row + 1); i++)
 	for (j = (char_col - 1); j <= (char_col + 1); j++)
 	  {
-	    d_ptr = &cave[i][j];
-	    if ((d_ptr->fval == LIGHT_FLOOR) && !d_ptr->pl)
+	    if ((cave[i][j].fval == LIGHT_FLOOR) && !cave_flag(cave_pl, i, j))
 	      light_room(i, j);
 	  }
     }
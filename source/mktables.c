@@ -0,0 +1,110 @@
+/* source/mktables.c: build time generator for the allocation tables
+
+   The monster and object allocation tables (m_level, t_level and
+   sorted_objects) follow entirely from c_list and object_list, so rather
+   than working them out every time the game starts, this program is built
+   and run as part of the build, with monsters.c and treasure.c linked in.
+   It writes a C source file that defines the tables as initialized const
+   data, which the game is then built with.
+
+   Usage: mktables <output.c> */
+
+#include "config.h"
+#include "types.h"
+#include "externs.h"
+
+/* unix.c isn't linked in, and the output path needs no tilde expansion */
+#ifdef fopen
+#undef fopen
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The tables being generated. Note that sorted_objects is not a stable
+   sort, and object generation depends on its exact order, so the way it
+   is sorted must not change. */
+static int16 gen_m_level[MAX_MONS_LEVEL + 1];
+static int16 gen_t_level[MAX_OBJ_LEVEL + 1];
+static int16 gen_sorted_objects[MAX_DUNGEON_OBJ];
+
+/* Count the monsters at each level, then make the counts cumulative, so
+   that monsters of level i are c_list[m_level[i-1] .. m_level[i]-1] */
+static void gen_m_levels()
+{
+  int i;
+
+  for (i = 0; i < MAX_CREATURES - WIN_MON_TOT; i++)
+    gen_m_level[c_list[i].level]++;
+  for (i = 1; i <= MAX_MONS_LEVEL; i++)
+    gen_m_level[i] += gen_m_level[i - 1];
+}
+
+/* Same for objects, and then produce an array with object indexes sorted
+   by level, by using the info in t_level; this is an O(n) sort */
+static void gen_t_levels()
+{
+  int i, l;
+  int tmp[MAX_OBJ_LEVEL + 1];
+
+  for (i = 0; i < MAX_DUNGEON_OBJ; i++)
+    gen_t_level[object_list[i].level]++;
+  for (i = 1; i <= MAX_OBJ_LEVEL; i++)
+    gen_t_level[i] += gen_t_level[i - 1];
+
+  for (i = 0; i <= MAX_OBJ_LEVEL; i++)
+    tmp[i] = 1;
+  for (i = 0; i < MAX_DUNGEON_OBJ; i++)
+  {
+    l = object_list[i].level;
+    gen_sorted_objects[gen_t_level[l] - tmp[l]] = (int16)i;
+    tmp[l]++;
+  }
+}
+
+static void gen_write(FILE *const fp, char const *const decl,
+                      int16 const *const table, const int n)
+{
+  int i;
+
+  (void) fprintf(fp, "\n%s = {", decl);
+  for (i = 0; i < n; i++)
+    (void) fprintf(fp, "%s%d", (i % 12) ? ", " : (i ? ",\n  " : "\n  "),
+                   table[i]);
+  (void) fprintf(fp, "\n};\n");
+}
+
+int main(int argc, char *argv[])
+{
+  FILE *fp;
+
+  if (argc != 2)
+  {
+    (void) fprintf(stderr, "usage: %s <output.c>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  gen_m_levels();
+  gen_t_levels();
+
+  if ((fp = fopen(argv[1], "w")) == NULL)
+  {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+  (void) fprintf(fp, "/* levels.c: generated by mktables from monsters.c "
+                 "and treasure.c, do not edit */\n\n"
+                 "#include \"config.h\"\n#include \"types.h\"\n"
+                 "#include \"externs.h\"\n");
+  gen_write(fp, "int16 const m_level[MAX_MONS_LEVEL+1]",
+            gen_m_level, MAX_MONS_LEVEL + 1);
+  gen_write(fp, "int16 const t_level[MAX_OBJ_LEVEL+1]",
+            gen_t_level, MAX_OBJ_LEVEL + 1);
+  gen_write(fp, "int16 const sorted_objects[MAX_DUNGEON_OBJ]",
+            gen_sorted_objects, MAX_DUNGEON_OBJ);
+  if (fclose(fp) != 0)
+  {
+    perror(argv[1]);
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -160,7 +160,7 @@ Resist	+	100000	Breathe/Resist Gas
 #ifdef MACGAME
 creature_type *c_list;
 #else
-creature_type c_list[MAX_CREATURES] = {
+creature_type const c_list[MAX_CREATURES] = {
 {"Filthy Street Urchin"	    ,0x0012000AL,0x00000000L,0x2034,    0,  40,
    4,	1, 11, 'p', {1,4}   , {72,148,0,0}		,    0},
 {"Blubbering Idiot"	    ,0x0012000AL,0x00000000L,0x2030,    0,   0,
@@ -730,7 +730,7 @@ creature_type c_list[MAX_CREATURES] = {
 #endif
 
 /* ERROR: attack #35 is no longer used */
-struct m_attack_type monster_attacks[N_MONS_ATTS] = {
+struct m_attack_type const monster_attacks[N_MONS_ATTS] = {
 /* 0 */	{0, 0, 0, 0},	{1, 1, 1, 2},	{1, 1, 1, 3},	{1, 1, 1, 4},
 	{1, 1, 1, 5},	{1, 1, 1, 6},	{1, 1, 1, 7},	{1, 1, 1, 8},
 	{1, 1, 1, 9},	{1, 1, 1, 10},	{1, 1, 1, 12},	{1, 1, 2, 2},
@@ -789,9 +789,9 @@ struct m_attack_type monster_attacks[N_MONS_ATTS] = {
 
 
 monster_type m_list[MAX_MALLOC];
-int16 m_level[MAX_MONS_LEVEL+1];
+/* m_level is generated from c_list at build time, see mktables.c */
 
 /* Blank monster values	*/
-monster_type blank_monster = {0,0,0,0,0,0,0,false,0,false};
+monster_type blank_monster = {0,0,0,0,0,0,0,false,0,false,0,0,0,0};
 int16 mfptr;			/* Cur free monster ptr	*/
 int16 mon_tot_mult;		/* # of repro's of creature	*/
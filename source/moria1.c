@@ -165,9 +165,28 @@ void calc_bonuses()
   m_ptr->dis_td	 = m_ptr->ptodam;  /* Display To Dam	    */
   m_ptr->dis_ac	 = 0;		/* Display AC		 */
   m_ptr->dis_tac = m_ptr->ptoac;   /* Display To AC	    */
+  /* one pass over the equipment collects the plusses, the flags and the
+     sustains */
+  item_flags = 0;
   for (i = INVEN_WIELD; i < INVEN_LIGHT; i++)
     {
       i_ptr = &inventory[i];
+      item_flags |= i_ptr->flags;
+#ifdef ATARIST_MWC
+      if ((holder = TR_SUST_STAT) & i_ptr->flags)
+#else
+      if (TR_SUST_STAT & i_ptr->flags)
+#endif
+	switch(i_ptr->p1)
+	  {
+	  case 1: p_ptr->sustain_str = true; break;
+	  case 2: p_ptr->sustain_int = true; break;
+	  case 3: p_ptr->sustain_wis = true; break;
+	  case 4: p_ptr->sustain_con = true; break;
+	  case 5: p_ptr->sustain_dex = true; break;
+	  case 6: p_ptr->sustain_chr = true; break;
+	  default: break;
+	  }
       if (i_ptr->tval != TV_NOTHING)
 	{
 	  m_ptr->ptohit += i_ptr->tohit;
@@ -217,13 +236,6 @@ void calc_bonuses()
     p_ptr->status |= PY_ARMOR;
 #endif
 
-  item_flags = 0;
-  i_ptr = &inventory[INVEN_WIELD];
-  for (i = INVEN_WIELD; i < INVEN_LIGHT; i++)
-    {
-      item_flags |= i_ptr->flags;
-      i_ptr++;
-    }
 #if !defined(ATARIST_MWC)
   if (TR_SLOW_DIGEST & item_flags)
     p_ptr->slow_digest = true;
@@ -284,27 +296,6 @@ void calc_bonuses()
     p_ptr->ffall = true;
 #endif
 
-  i_ptr = &inventory[INVEN_WIELD];
-  for (i = INVEN_WIELD; i < INVEN_LIGHT; i++)
-    {
-#ifdef ATARIST_MWC
-      if ((holder = TR_SUST_STAT) & i_ptr->flags)
-#else
-      if (TR_SUST_STAT & i_ptr->flags)
-#endif
-	switch(i_ptr->p1)
-	  {
-	  case 1: p_ptr->sustain_str = true; break;
-	  case 2: p_ptr->sustain_int = true; break;
-	  case 3: p_ptr->sustain_wis = true; break;
-	  case 4: p_ptr->sustain_con = true; break;
-	  case 5: p_ptr->sustain_dex = true; break;
-	  case 6: p_ptr->sustain_chr = true; break;
-	  default: break;
-	  }
-      i_ptr++;
-    }
-
   if (p_ptr->slow_digest)
     p_ptr->food_digested--;
   if (p_ptr->regenerate)
@@ -338,7 +329,7 @@ char *mask;
     {
       if (mask == CNIL || mask[i])
 	{
-	  objdes(tmp_val, &inventory[i], true);
+	  inven_objdes(tmp_val, i);
 	  tmp_val[lim] = 0;	 /* Truncate if too long. */
 	  (void) sprintf(out_val[i], "%c) %s", 'a'+i, tmp_val);
 	  l = strlen(out_val[i]) + 2;
@@ -475,7 +466,7 @@ int weight, col;
 	    default:
 	      prt1 = "Unknown value"; break;
 	    }
-	  objdes(prt2, &inventory[i], true);
+	  inven_objdes(prt2, i);
 	  prt2[lim] = 0; /* Truncate if necessary */
 	  (void) sprintf(out_val[line], "%c) %-14s: %s", line+'a',
 			 prt1, prt2);
@@ -566,7 +557,7 @@ int item;
 {
   bigvtype out_str, object;
 
-  objdes(object, &inventory[item], true);
+  inven_objdes(object, item);
   object[strlen(object)-1] = '?'; /* change the period to a question mark */
   (void) sprintf(out_str, "%s %s", prompt, object);
   return get_check(out_str);
@@ -1459,10 +1450,8 @@ char *message;
 /* Returns true if player has no light			-RAK-	*/
 int no_light()
 {
-  register cave_type *c_ptr;
-
-  c_ptr = &cave[char_row][char_col];
-  if (!c_ptr->tl && !c_ptr->pl)
+  if (!cave_flag(cave_tl, char_row, char_col) &&
+      !cave_flag(cave_pl, char_row, char_col))
     return true;
   return false;
 }
@@ -1591,6 +1580,8 @@ register int y1, x1, y2, x2;
   tmp = cave[y1][x1].cptr;
   cave[y1][x1].cptr = 0;
   cave[y2][x2].cptr = tmp;
+  screen_map_spot(y1, x1);
+  screen_map_spot(y2, x2);
 }
 
 
@@ -1599,8 +1590,9 @@ void light_room(y, x)
 int y, x;
 {
   register int i, j, start_col, end_col;
-  int tmp1, tmp2, start_row, end_row;
+  int tmp1, tmp2, start_row, end_row, w;
   register cave_type *c_ptr;
+  int64u todo;
   int tval;
 
   tmp1 = (SCREEN_HEIGHT/2);
@@ -1612,20 +1604,27 @@ int y, x;
   for (i = start_row; i <= end_row; i++)
     for (j = start_col; j <= end_col; j++)
       {
+	/* skip a word at a time past squares already lit or not in a room */
+	w = j >> 6;
+	todo = cave_lr[i][w] & ~cave_pl[i][w];
+	if ((todo >> (j & 63)) == 0)
+	  {
+	    j |= 63;
+	    continue;
+	  }
+	if ((todo & CAVE_BIT(j)) == 0)
+	  continue;
 	c_ptr = &cave[i][j];
-	if (c_ptr->lr && ! c_ptr->pl)
+	cave_on(cave_pl, i, j);
+	if (c_ptr->fval == DARK_FLOOR)
+	  c_ptr->fval = LIGHT_FLOOR;
+	if (!cave_flag(cave_fm, i, j) && c_ptr->tptr != 0)
 	  {
-	    c_ptr->pl = true;
-	    if (c_ptr->fval == DARK_FLOOR)
-	      c_ptr->fval = LIGHT_FLOOR;
-	    if (! c_ptr->fm && c_ptr->tptr != 0)
-	      {
-		tval = t_list[c_ptr->tptr].tval;
-		if (tval >= TV_MIN_VISIBLE && tval <= TV_MAX_VISIBLE)
-		  c_ptr->fm = true;
-	      }
-	    print(loc_symbol(i, j), i, j);
+	    tval = t_list[c_ptr->tptr].tval;
+	    if (tval >= TV_MIN_VISIBLE && tval <= TV_MAX_VISIBLE)
+	      cave_on(cave_fm, i, j);
 	  }
+	print(loc_symbol(i, j), i, j);
       }
 }
 
@@ -1636,6 +1635,8 @@ register int y, x;
 {
   if (panel_contains(y, x))
     print(loc_symbol(y, x), y, x);
+  else
+    screen_map_spot(y, x);
 }
 
 
@@ -1651,29 +1652,28 @@ int y1, y2;
 
   if (light_flag)
     {
-      for (i = y1-1; i <= y1+1; i++)	   /* Turn off lamp light	*/
-	for (j = x1-1; j <= x1+1; j++)
-	  cave[i][j].tl = false;
+      /* Turn off lamp light	*/
+      cave_fill(cave_tl, y1-1, x1-1, y1+1, x1+1, false);
       if (find_flag && !find_prself)
 	light_flag = false;
     }
   else if (!find_flag || find_prself)
     light_flag = true;
 
+  /* only light up if normal movement */
+  if (light_flag)
+    cave_fill(cave_tl, y2-1, x2-1, y2+1, x2+1, true);
   for (i = y2-1; i <= y2+1; i++)
     for (j = x2-1; j <= x2+1; j++)
       {
 	c_ptr = &cave[i][j];
-	/* only light up if normal movement */
-	if (light_flag)
-	  c_ptr->tl = true;
 	if (c_ptr->fval >= MIN_CAVE_WALL)
-	  c_ptr->pl = true;
-	else if (!c_ptr->fm && c_ptr->tptr != 0)
+	  cave_on(cave_pl, i, j);
+	else if (!cave_flag(cave_fm, i, j) && c_ptr->tptr != 0)
 	  {
 	    tval = t_list[c_ptr->tptr].tval;
 	    if ((tval >= TV_MIN_VISIBLE) && (tval <= TV_MAX_VISIBLE))
-	      c_ptr->fm = true;
+	      cave_on(cave_fm, i, j);
 	  }
       }
 
@@ -1717,7 +1717,7 @@ int y2, x2;
       for (i = y1-1; i <= y1+1; i++)
 	for (j = x1-1; j <= x1+1; j++)
 	  {
-	    cave[i][j].tl = false;
+	    cave_off(cave_tl, i, j);
 	    print(loc_symbol(i, j), i, j);
 	  }
       light_flag = false;
@@ -1882,6 +1882,8 @@ int damage;
 char *hit_from;
 {
   if (py.flags.invuln > 0)  damage = 0;
+  if (damage > 0)
+    event_log(EV_DAMAGE, hit_from, (int32)damage);
   py.misc.chp -= damage;
   if (py.misc.chp < 0)
     {
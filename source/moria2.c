@@ -403,7 +403,7 @@ int dir, y, x;
 	    {
 	      /* Objects player can see (Including doors?) cause a stop. */
 	      c_ptr = &cave[row][col];
-	      if (player_light || c_ptr->tl || c_ptr->pl || c_ptr->fm)
+	      if (player_light || test_light(row, col))
 		{
 		  if (c_ptr->tptr != 0)
 		    {
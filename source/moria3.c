@@ -258,7 +258,7 @@ int *sn, *sc;
   int32u j;
   register int i, k;
   int spell[31], result, first_spell;
-  register spell_type *s_ptr;
+  register spell_type const *s_ptr;
 
   result = -1;
   i = 0;
@@ -352,6 +352,7 @@ int pickup;
 		{
 		  locn = inven_carry(i_ptr);
 		  objdes(tmp_str, &inventory[locn], true);
+		  event_log(EV_PICKUP, tmp_str, (int32)i_ptr->number);
 		  (void) sprintf(out_val, "You have %s (%c)",tmp_str,locn+'a');
 		  msg_print(out_val);
 		  (void) delete_object(y, x);
@@ -498,10 +499,13 @@ int y, x;
 
   c_ptr = &cave[y][x];
   if (c_ptr->fval == BLOCKED_FLOOR)
-    c_ptr->fval = CORR_FLOOR;
+    {
+      c_ptr->fval = CORR_FLOOR;
+      flow_reset();
+    }
   pusht(c_ptr->tptr);
   c_ptr->tptr = 0;
-  c_ptr->fm = false;
+  cave_off(cave_fm, y, x);
   lite_spot(y, x);
   if (test_light(y, x))
     delete = true;
@@ -648,7 +652,7 @@ int monptr, dam;
   int32 new_exp, new_exp_frac;
   register monster_type *m_ptr;
   register struct misc *p_ptr;
-  register creature_type *c_ptr;
+  register creature_type const *c_ptr;
   int m_take_hit;
   int32u tmp;
 #ifdef ATARIST_MWC
@@ -701,6 +705,7 @@ int monptr, dam;
 	p_ptr->exp_frac = new_exp_frac;
 
       p_ptr->exp += new_exp;
+      event_log(EV_KILL, c_ptr->name, new_exp);
       /* can't call prt_experience() here, as that would result in "new level"
 	 message appearing before "monster dies" message */
       m_take_hit = m_ptr->mptr;
@@ -849,7 +854,7 @@ int dir, do_pickup;
   int old_row, old_col, old_find_flag;
   int y, x;
   register int i, j;
-  register cave_type *c_ptr, *d_ptr;
+  register cave_type *c_ptr;
 
   if ((py.flags.confused > 0) &&    /* Confused?	     */
       (randint(4) > 1) &&	    /* 75% random movement   */
@@ -894,18 +899,18 @@ int dir, do_pickup;
 	      /* A room of light should be lit.	     */
 	      if (c_ptr->fval == LIGHT_FLOOR)
 		{
-		  if (!c_ptr->pl && !py.flags.blind)
+		  if (!cave_flag(cave_pl, char_row, char_col) &&
+		      !py.flags.blind)
 		    light_room(char_row, char_col);
 		}
 	      /* In doorway of light-room?	       */
-	      else if (c_ptr->lr && (py.flags.blind < 1))
+	      else if (cave_flag(cave_lr, char_row, char_col) &&
+		       (py.flags.blind < 1))
 		for (i = (char_row - 1); i <= (char_row + 1); i++)
 		  for (j = (char_col - 1); j <= (char_col + 1); j++)
-		    {
-		      d_ptr = &cave[i][j];
-		      if ((d_ptr->fval == LIGHT_FLOOR) && (!d_ptr->pl))
-			light_room(i, j);
-		    }
+		    if ((cave[i][j].fval == LIGHT_FLOOR) &&
+			!cave_flag(cave_pl, i, j))
+		      light_room(i, j);
 	      /* Move the light source		       */
 	      move_light(old_row, old_col, char_row, char_col);
 	      /* An object is beneath him.	     */
@@ -1221,7 +1226,7 @@ int y, x, t1, t2;
   if (t1 > t2)
     {
       c_ptr = &cave[y][x];
-      if (c_ptr->lr)
+      if (cave_flag(cave_lr, y, x))
 	{
 	  /* should become a room space, check to see whether it should be
 	     LIGHT_FLOOR or DARK_FLOOR */
@@ -1231,27 +1236,29 @@ int y, x, t1, t2;
 	      if (cave[i][j].fval <= MAX_CAVE_ROOM)
 		{
 		  c_ptr->fval = cave[i][j].fval;
-		  c_ptr->pl = cave[i][j].pl;
+		  cave_put(cave_pl, y, x, cave_flag(cave_pl, i, j));
 		  found = true;
 		  break;
 		}
 	  if (!found)
 	    {
 	      c_ptr->fval = CORR_FLOOR;
-	      c_ptr->pl = false;
+	      cave_off(cave_pl, y, x);
 	    }
 	}
       else
 	{
 	  /* should become a corridor space */
 	  c_ptr->fval  = CORR_FLOOR;
-	  c_ptr->pl = false;
+	  cave_off(cave_pl, y, x);
 	}
-      c_ptr->fm = false;
+      cave_off(cave_fm, y, x);
       if (panel_contains(y, x))
-	if ((c_ptr->tl || c_ptr->pl) && c_ptr->tptr != 0)
+	if ((cave_flag(cave_tl, y, x) || cave_flag(cave_pl, y, x)) &&
+	    c_ptr->tptr != 0)
 	  msg_print("You have found something!");
       lite_spot(y, x);
+      flow_reset();
       res = true;
     }
   return(res);
@@ -637,7 +637,7 @@ int *transparent;
 	  restore_screen();
 	}
     }
-  if (c_ptr->tl || c_ptr->pl || c_ptr->fm)
+  if (test_light(y, x))
     {
       if (c_ptr->tptr != 0)
 	{
@@ -851,7 +851,7 @@ inven_type *t_ptr;
   if (flag)
     {
       cur_pos = popt();
-      cave[i][j].tptr = cur_pos;
+      set_tptr(i, j, cur_pos);
       t_list[cur_pos] = *t_ptr;
       lite_spot(i, j);
     }
@@ -912,7 +912,6 @@ void throw_object()
 	    {
 	      (void) mmove(dir, &y, &x);
 	      cur_dis++;
-	      lite_spot(oldy, oldx);
 	      if (cur_dis > tdis)  flag = true;
 	      c_ptr = &cave[y][x];
 	      if ((c_ptr->fval <= MAX_OPEN_SPACE) && (!flag))
@@ -920,6 +919,8 @@ void throw_object()
 		  if (c_ptr->cptr > 1)
 		    {
 		      flag = true;
+		      /* show the object's flight before it lands */
+		      anim_flush();
 		      m_ptr = &m_list[c_ptr->cptr];
 		      tbth = tbth - cur_dis;
 		      /* if monster not lit, make it much more difficult to
@@ -971,18 +972,19 @@ void throw_object()
 			drop_throw(oldy, oldx, &throw_obj);
 		    }
 		  else
-		    {	/* do not test c_ptr->fm here */
+		    {	/* do not test fm here */
 		      if (panel_contains(y, x) && (py.flags.blind < 1)
-			  && (c_ptr->tl || c_ptr->pl))
+			  && (cave_flag(cave_tl, y, x) || cave_flag(cave_pl, y, x)))
 			{
-			  print(tchar, y, x);
-			  put_qio(); /* show object moving */
+			  anim_frame(); /* queue object moving */
+			  anim_cell(tchar, y, x);
 			}
 		    }
 		}
 	      else
 		{
 		  flag = true;
+		  anim_flush();
 		  drop_throw(oldy, oldx, &throw_obj);
 		}
 	      oldy = y;
@@ -1000,7 +1002,7 @@ static void py_bash(y, x)
 int y, x;
 {
   int monster, k, avg_max_hp, base_tohit;
-  register creature_type *c_ptr;
+  register creature_type const *c_ptr;
   register monster_type *m_ptr;
   vtype m_name, out_val;
 
@@ -187,9 +187,7 @@ void msdos_init()
       else {
         wallsym = (int8u) arg1;
         floorsym = (int8u) arg2;
-
-        /* Adjust lists that depend on '#' and '.' */
-        object_list[OBJ_SECRET_DOOR].tchar = wallsym;
+        /* secret doors pick up wallsym in place_secret_door() */
       }
     }
     else if (strcmpi(opt, "SAVE") == 0) {
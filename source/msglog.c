@@ -0,0 +1,265 @@
+/* source/msglog.c: the message history
+
+   Every message printed on the top line is added to the message log,
+   which is kept for the whole game and saved with the character.  Each
+   different message text is only stored once: the texts are interned into
+   one string pool and found again through a hash table, and the log itself
+   is a list of small entries, each giving the number of a text and how
+   many times in a row it was printed.  A long game's history thus takes a
+   few kilobytes, and the ^P command can page back through all of it.
+
+   The log can hold up to MSG_LOG_TEXTS different texts; once that many
+   have been seen, messages with new texts are no longer logged, though
+   repeats of the known ones still are. */
+
+#include "config.h"
+#include "types.h"
+#include "externs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* messages shown per page by msglog_browse() */
+#define MSG_LOG_PAGE 22
+
+typedef struct msg_entry
+{
+  int16u text;  /* number of the text */
+  int16u count; /* times printed in a row */
+} msg_entry;
+
+/* the interned texts, each NUL terminated, text n starting at
+   ml_pool[ml_start[n]] */
+static char *ml_pool = NULL;
+static int32u ml_pool_used = 0, ml_pool_size = 0;
+static int32u *ml_start = NULL;
+static int32u ml_texts = 0, ml_texts_size = 0;
+/* open addressing hash table of text numbers plus one, 0 if unused; its
+   size is a power of two, kept at least twice the number of texts */
+static int16u *ml_hash = NULL;
+static int32u ml_hash_size = 0;
+/* the log, oldest entry first */
+static msg_entry *ml_log = NULL;
+static int32u ml_len = 0, ml_size = 0;
+
+static int32u ml_hash_text(char const *s)
+{
+  int32u h = 2166136261UL;
+
+  while (*s != '\0')
+  {
+    h ^= (int8u)*s++;
+    h = (h * 16777619UL) & 0xFFFFFFFFUL;
+  }
+  return h;
+}
+
+/* Grow an array to hold at least n elements of the given size, doubling
+   from first; returns false if there is not enough memory */
+static bool ml_grow(void **const ptr, int32u *const size, const int32u n,
+                    const size_t elem, const int32u first)
+{
+  int32u new_size = *size ? *size : first;
+  void *p;
+
+  if (n <= *size) return true;
+  while (new_size < n) new_size *= 2;
+  if ((p = realloc(*ptr, (size_t)new_size * elem)) == NULL) return false;
+  *ptr = p;
+  *size = new_size;
+  return true;
+}
+
+/* Put every text back into a hash table of the given size */
+static bool ml_rehash(const int32u size)
+{
+  int16u *table;
+  int32u i, h;
+
+  if ((table = (int16u *)calloc((size_t)size, sizeof(int16u))) == NULL)
+    return false;
+  for (i = 0; i < ml_texts; i++)
+  {
+    h = ml_hash_text(&ml_pool[ml_start[i]]) & (size - 1);
+    while (table[h] != 0) h = (h + 1) & (size - 1);
+    table[h] = (int16u)(i + 1);
+  }
+  free(ml_hash);
+  ml_hash = table;
+  ml_hash_size = size;
+  return true;
+}
+
+/* Forget every message */
+void msglog_clear()
+{
+  ml_pool_used = 0;
+  ml_texts = 0;
+  ml_len = 0;
+  if (ml_hash != NULL)
+    (void) memset(ml_hash, 0, (size_t)ml_hash_size * sizeof(int16u));
+}
+
+/* Returns the number of the given text, adding it if it is new, or -1 if
+   the log has no room for it.  Texts are cut to fit a vtype. */
+int msglog_intern(char const *const text)
+{
+  vtype buf;
+  int32u h, len;
+  int16u id;
+
+  (void) strncpy(buf, text, VTYPESIZ - 1);
+  buf[VTYPESIZ - 1] = '\0';
+
+  if (ml_hash_size > 0)
+  {
+    h = ml_hash_text(buf) & (ml_hash_size - 1);
+    while ((id = ml_hash[h]) != 0)
+    {
+      if (strcmp(&ml_pool[ml_start[id - 1]], buf) == 0) return id - 1;
+      h = (h + 1) & (ml_hash_size - 1);
+    }
+  }
+
+  len = (int32u)strlen(buf) + 1;
+  if (ml_texts >= MSG_LOG_TEXTS
+      || !ml_grow((void **)&ml_pool, &ml_pool_size, ml_pool_used + len,
+                  sizeof(char), 1024)
+      || !ml_grow((void **)&ml_start, &ml_texts_size, ml_texts + 1,
+                  sizeof(int32u), 64)
+      || ((ml_texts + 1) * 2 > ml_hash_size
+          && !ml_rehash(ml_hash_size ? ml_hash_size * 2 : 128)))
+    return -1;
+
+  (void) memcpy(&ml_pool[ml_pool_used], buf, (size_t)len);
+  ml_start[ml_texts] = ml_pool_used;
+  ml_pool_used += len;
+  h = ml_hash_text(buf) & (ml_hash_size - 1);
+  while (ml_hash[h] != 0) h = (h + 1) & (ml_hash_size - 1);
+  ml_hash[h] = (int16u)(ml_texts + 1);
+  return (int)ml_texts++;
+}
+
+/* Add count printings of text number text to the end of the log, folding
+   them into the last entry if it has the same text; returns false if text
+   is not a known text, or there is no memory */
+bool msglog_append(const int text, const int count)
+{
+  msg_entry *e;
+
+  if (text < 0 || (int32u)text >= ml_texts || count < 1) return false;
+  if (ml_len > 0)
+  {
+    e = &ml_log[ml_len - 1];
+    if (e->text == text && (int32u)e->count + count <= 0xFFFF)
+    {
+      e->count += count;
+      return true;
+    }
+  }
+  if (!ml_grow((void **)&ml_log, &ml_size, ml_len + 1, sizeof(msg_entry),
+               256))
+    return false;
+  ml_log[ml_len].text = (int16u)text;
+  ml_log[ml_len].count = (int16u)count;
+  ml_len++;
+  return true;
+}
+
+/* Log a message that has just been printed */
+void msglog_add(char const *const msg)
+{
+  int text = msglog_intern(msg);
+
+  if (text >= 0) (void) msglog_append(text, 1);
+}
+
+/* Returns the number of entries in the log */
+int32u msglog_size()
+{
+  return ml_len;
+}
+
+/* Returns the number of different texts in the log */
+int32u msglog_texts()
+{
+  return ml_texts;
+}
+
+/* Returns text number n */
+char const *msglog_text(const int32u n)
+{
+  return &ml_pool[ml_start[n]];
+}
+
+/* Gets log entry n, counting from the oldest */
+void msglog_entry(const int32u n, int *const text, int *const count)
+{
+  *text = ml_log[n].text;
+  *count = ml_log[n].count;
+}
+
+/* Formats log entry n, counting back from the latest, into a vtype, with
+   its repeat count if it has one */
+void msglog_line(const int32u n, char *const buf)
+{
+  msg_entry const *e = &ml_log[ml_len - 1 - n];
+  char count[16];
+
+  if (e->count > 1)
+    (void) sprintf(count, " (x%d)", (int)e->count);
+  else
+    count[0] = '\0';
+  (void) sprintf(buf, "%.*s%s", (int)(VTYPESIZ - 1 - strlen(count)),
+                 &ml_pool[ml_start[e->text]], count);
+}
+
+/* Show the message history a page of lines messages at a time, starting
+   with the latest; lines is cut to the screen, and 0 means a full page */
+void msglog_browse(int32u lines)
+{
+  bigvtype buf;
+  int32u top, i;
+  char ch;
+
+  if (ml_len == 0) return;
+  if (lines == 0 || lines > MSG_LOG_PAGE) lines = MSG_LOG_PAGE;
+  if (lines > ml_len) lines = ml_len;
+  /* top is the entry shown on the first line, counting back from the
+     latest, so the page shows entries top down to top - lines + 1 */
+  top = lines - 1;
+
+  save_screen();
+  for (;;)
+  {
+    clear_screen();
+    for (i = 0; i < lines && i <= top; i++)
+    {
+      msglog_line(top - i, buf);
+      prt(buf, (int)i, 0);
+    }
+    (void) sprintf(buf, "[Messages %lu-%lu of %lu: - older, + newer, "
+                   "ESC to return]", (unsigned long)(ml_len - top),
+                   (unsigned long)(ml_len - top + i - 1),
+                   (unsigned long)ml_len);
+    prt(buf, MSG_LOG_PAGE + 1, 0);
+    ch = inkey();
+    if (ch == '-' || ch == ' ')
+    {
+      /* space pages back until the oldest message, then returns */
+      if (top + 1 < ml_len)
+      {
+        top += lines;
+        if (top >= ml_len) top = ml_len - 1;
+      }
+      else if (ch == ' ')
+        break;
+    }
+    else if (ch == '+')
+      top = (top >= 2 * lines - 1) ? top - lines : lines - 1;
+    else if (ch == ESCAPE)
+      break;
+  }
+  restore_screen();
+}
@@ -34,7 +34,7 @@ int16u player_hp[MAX_PLAYER_LEVEL];
 #ifdef MACGAME
 char *(*player_title)[MAX_PLAYER_LEVEL];
 #else
-char *player_title[MAX_CLASS][MAX_PLAYER_LEVEL] = {
+char *const player_title[MAX_CLASS][MAX_PLAYER_LEVEL] = {
 	/* Warrior	 */
 {"Rookie","Private","Soldier","Mercenary","Veteran(1st)","Veteran(2nd)",
 "Veteran(3rd)","Warrior(1st)","Warrior(2nd)","Warrior(3rd)","Warrior(4th)",
@@ -93,7 +93,7 @@ char *player_title[MAX_CLASS][MAX_PLAYER_LEVEL] = {
 #endif
 
 /* Base experience levels, may be adjusted up for race and/or class*/
-int32u player_exp[MAX_PLAYER_LEVEL] = {
+int32u const player_exp[MAX_PLAYER_LEVEL] = {
       10,      25,	45,	 70,	  100,	    140,      200,	280,
      380,     500,     650,	850,	 1100,	   1400,     1800,     2300,
     2900,    3600,    4400,    5400,	 6800,	   8400,    10200,    12500,
@@ -108,7 +108,7 @@ int32u player_exp[MAX_PLAYER_LEVEL] = {
 #ifdef MACGAME
 race_type *race;
 #else
-race_type race[MAX_RACES] = {
+race_type const race[MAX_RACES] = {
    {"Human",	 0,  0,	 0,  0,	 0,  0,
       14,  6, 72,  6,180, 25, 66,  4,150, 20,
       0,  0,  0,  0,  0,  0,  0, 10,  0, 100, 0x3F,
@@ -148,7 +148,7 @@ race_type race[MAX_RACES] = {
 #ifdef MACGAME
 background_type *background;
 #else
-background_type background[MAX_BACKGROUND] = {
+background_type const background[MAX_BACKGROUND] = {
 {"You are the illegitimate and unacknowledged child ",		 10, 1, 2, 25},
 {"You are the illegitimate but acknowledged child ",		 20, 1, 2, 35},
 {"You are one of several children ",				 95, 1, 2, 45},
@@ -281,7 +281,7 @@ background_type background[MAX_BACKGROUND] = {
 #endif
 
 /* Classes.							*/
-class_type class[MAX_CLASS] = {
+class_type const class[MAX_CLASS] = {
 /*	  HP Dis Src Stl Fos bth btb sve S  I  W  D Co Ch  Spell Exp  spl */
 {"Warrior",9, 25, 14, 1, 38, 70, 55, 18, 5,-2,-2, 2, 2,-1, NONE,    0, 0},
 {"Mage",   0, 30, 16, 2, 20, 34, 20, 36,-5, 3, 0, 1,-2, 1, MAGE,   30, 1},
@@ -295,7 +295,7 @@ class_type class[MAX_CLASS] = {
    headaches in its use */
 /* CLA_MISC_HIT is identical to CLA_SAVE, which takes advantage of
    the fact that the save values are independent of the class */
-int16 class_level_adj[MAX_CLASS][MAX_LEV_ADJ] = {
+int16 const class_level_adj[MAX_CLASS][MAX_LEV_ADJ] = {
 /*	       bth    bthb   device  disarm   save/misc hit  */
 /* Warrior */ {	4,	4,	2,	2,	3 },
 /* Mage    */ { 2,	2,	4,	3,	3 },
@@ -316,7 +316,7 @@ int8u spell_order[32];		/* order spells learned/remembered/forgotten */
 #ifdef MACGAME
 spell_type (*magic_spell)[31];
 #else
-spell_type magic_spell[MAX_CLASS-1][31] = {
+spell_type const magic_spell[MAX_CLASS-1][31] = {
   {		  /* Mage	   */
      {	1,  1, 22,   1},
      {	1,  1, 23,   1},
@@ -485,7 +485,7 @@ spell_type magic_spell[MAX_CLASS-1][31] = {
  };
 #endif
 
-char *spell_names[62] = {
+char *const spell_names[62] = {
   /* Mage Spells */
   "Magic Missile",  "Detect Monsters",	"Phase Door",  "Light Area",
   "Cure Light Wounds",	"Find Hidden Traps/Doors",  "Stinking Cloud",
@@ -511,7 +511,7 @@ char *spell_names[62] = {
 /* 344 = Food Ration, 365 = Wooden Torch, 123 = Cloak, 318 = Beginners-Majik,
    103 = Soft Leather Armor, 30 = Stiletto, 322 = Beginners Handbook */
 
-int16u player_init[MAX_CLASS][5] = {
+int16u const player_init[MAX_CLASS][5] = {
 		{ 344, 365, 123,  30, 103},	/* Warrior	 */
 		{ 344, 365, 123,  30, 318},	/* Mage		 */
 		{ 344, 365, 123,  30, 322},	/* Priest	 */
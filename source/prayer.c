@@ -26,7 +26,7 @@ void pray()
 {
   int i, j, item_val, dir;
   int choice, chance, result;
-  register spell_type *s_ptr;
+  register spell_type const *s_ptr;
   register struct misc *m_ptr;
   register struct flags *f_ptr;
   register inven_type *i_ptr;
@@ -0,0 +1,96 @@
+/* source/profile.c: hot path profiling counters
+
+   When the game is built with PROFILE defined, the functions the game
+   spends most of its time in are bracketed with PROF_ENTER() and
+   PROF_LEAVE(), which count the calls to each one and add up the processor
+   cycles spent inside it, including any time spent in the other counted
+   functions it calls.  The counters can be looked at during play with the
+   wizard mode '%' command, and are appended to the file <savefile>.prof
+   when the game exits.  Without PROFILE the brackets compile to nothing. */
+
+#include "config.h"
+#include "types.h"
+#include "externs.h"
+
+#ifdef PROFILE
+
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
+
+#include <stdio.h>
+#include <time.h>
+
+/* deepest nesting of counted functions that is timed */
+#define PROF_DEPTH 16
+
+static char const *const prof_names[PROF_MAX] = {
+  "creatures", "update_mon", "los", "prt_map", "generate_cave",
+  "save_char", "compact_objects", "pusht", "put_qio"
+};
+
+static int32u prof_calls[PROF_MAX];
+static int64u prof_cycles[PROF_MAX];
+/* start times of the counted functions currently running */
+static int64u prof_stack[PROF_DEPTH];
+static int prof_depth = 0;
+
+static int64u prof_clock(void)
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+  return __builtin_ia32_rdtsc();
+#elif defined(_MSC_VER)
+  return __rdtsc();
+#else
+  return (int64u)clock();
+#endif
+}
+
+void prof_enter(const int id)
+{
+  (void)id;
+  if (prof_depth < PROF_DEPTH) prof_stack[prof_depth] = prof_clock();
+  prof_depth++;
+}
+
+void prof_leave(const int id)
+{
+  prof_depth--;
+  prof_calls[id]++;
+  if (prof_depth < PROF_DEPTH)
+    prof_cycles[id] += prof_clock() - prof_stack[prof_depth];
+}
+
+/* Formats one counter as a line of at most 80 columns */
+void prof_describe(const int id, char *const buf)
+{
+  double const cycles = (double)prof_cycles[id];
+
+  (void) sprintf(buf, "%-16s %10lu calls %16.0f cycles %12.0f each",
+                 prof_names[id], (unsigned long)prof_calls[id], cycles,
+                 prof_calls[id] ? cycles / prof_calls[id] : 0.0);
+}
+
+/* Appends the counters for this session to <savefile>.prof */
+void prof_dump()
+{
+  FILE *fp;
+  vtype name;
+  bigvtype line;
+  time_t now;
+  int i;
+
+  (void) sprintf(name, "%s.prof", savefile);
+  if ((fp = fopen(name, "a")) == NULL) return;
+  now = time(NULL);
+  (void) fprintf(fp, "session ending %s", ctime(&now));
+  for (i = 0; i < PROF_MAX; i++)
+  {
+    prof_describe(i, line);
+    (void) fprintf(fp, "%s\n", line);
+  }
+  (void) fprintf(fp, "\n");
+  (void) fclose(fp);
+}
+
+#endif /* PROFILE */
@@ -161,10 +161,10 @@ int roff_recall(mon_num)
 int mon_num;
 {
   char *p, *q;
-  int8u *pu;
+  int8u const *pu;
   vtype temp;
   register recall_type *mp;
-  register creature_type *cp;
+  register creature_type const *cp;
   register int i, k;
   register int32u j;
   int32 templong;
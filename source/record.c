@@ -0,0 +1,262 @@
+/* source/record.c: ttyrec format session recorder
+
+   When the MORIA_RECORD environment variable names a file, every frame the
+   output layer sends to the screen (as encoded by spectate_frame()) is
+   appended to it as a ttyrec record: three little endian 32 bit words
+   holding the seconds, microseconds and length of the frame, then the frame
+   itself.  The result can be played back with any ttyrec player.
+
+   The game never waits on the disk.  Frames are stamped and copied into an
+   in-memory ring buffer, and a background thread drains the ring to the
+   file.  The lock is only held long enough to read or update the ring
+   indices.  If the writer ever falls so far behind that a frame does not
+   fit, the frame is dropped and the caller is told, so that it can send a
+   full redraw next time and the recording stays correct from then on. */
+
+#include "config.h"
+#include "externs.h"
+
+#if defined(_MSC_VER) || defined(__MINGW32__) /* Windows */
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+#else
+# include <pthread.h>
+# include <sys/time.h>
+#endif
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REC_RING_SIZE   (1024L * 1024L)
+#define REC_HEADER_SIZE 12
+
+static FILE *rec_fp = NULL;
+static char rec_ring[REC_RING_SIZE];
+/* stream offsets, only ever compared by difference, so they may wrap;
+   rec_head is advanced by the game, rec_tail by the writer thread */
+static int32u rec_head, rec_tail;
+static bool rec_done;
+/* set while record_frame() runs; a signal handler that ends the game from
+   inside it must not wait for rec_lock, which may be held */
+static volatile sig_atomic_t rec_busy = 0;
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+static CRITICAL_SECTION rec_lock;
+static HANDLE rec_wake, rec_thread;
+# define REC_LOCK()   EnterCriticalSection(&rec_lock)
+# define REC_UNLOCK() LeaveCriticalSection(&rec_lock)
+#else
+static pthread_mutex_t rec_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t rec_wake = PTHREAD_COND_INITIALIZER;
+static pthread_t rec_thread;
+# define REC_LOCK()   (void) pthread_mutex_lock(&rec_lock)
+# define REC_UNLOCK() (void) pthread_mutex_unlock(&rec_lock)
+#endif
+
+static void rec_put32(char *p, const int32u v)
+{
+  p[0] = (char)(v & 0xFF);
+  p[1] = (char)((v >> 8) & 0xFF);
+  p[2] = (char)((v >> 16) & 0xFF);
+  p[3] = (char)((v >> 24) & 0xFF);
+}
+
+/* Copy len bytes to the ring at stream offset pos, wrapping as needed */
+static void rec_copy_in(const int32u pos, char const *buf, const int32u len)
+{
+  int32u off = pos % REC_RING_SIZE;
+  int32u n = REC_RING_SIZE - off;
+
+  if (n > len) n = len;
+  memcpy(&rec_ring[off], buf, n);
+  if (n < len) memcpy(rec_ring, buf + n, len - n);
+}
+
+/* Write the ring contents between stream offsets from and to to the file */
+static void rec_drain(const int32u from, const int32u to)
+{
+  int32u off = from % REC_RING_SIZE;
+  int32u len = to - from;
+  int32u n = REC_RING_SIZE - off;
+
+  if (n > len) n = len;
+  (void) fwrite(&rec_ring[off], 1, n, rec_fp);
+  if (n < len) (void) fwrite(rec_ring, 1, len - n, rec_fp);
+  (void) fflush(rec_fp);
+}
+
+/* Wait until there is something to write, then write it; returns false
+   once the game is over and everything has been written */
+static bool rec_writer_step()
+{
+  int32u head, tail;
+  bool done;
+
+  REC_LOCK();
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  while (rec_head == rec_tail && !rec_done)
+  {
+    REC_UNLOCK();
+    (void) WaitForSingleObject(rec_wake, INFINITE);
+    REC_LOCK();
+  }
+#else
+  while (rec_head == rec_tail && !rec_done)
+    (void) pthread_cond_wait(&rec_wake, &rec_lock);
+#endif
+  head = rec_head;
+  tail = rec_tail;
+  done = rec_done;
+  REC_UNLOCK();
+
+  if (head == tail) return !done;
+  rec_drain(tail, head);
+  REC_LOCK();
+  rec_tail = head;
+  REC_UNLOCK();
+  return true;
+}
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+static DWORD WINAPI rec_writer(LPVOID arg)
+#else
+static void *rec_writer(void *arg)
+#endif
+{
+  (void) arg;
+  while (rec_writer_step())
+    ;
+  return 0;
+}
+
+static void rec_signal()
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  (void) SetEvent(rec_wake);
+#else
+  (void) pthread_cond_signal(&rec_wake);
+#endif
+}
+
+/* Start recording if MORIA_RECORD names a file to record to */
+void record_init()
+{
+  char *p = getenv("MORIA_RECORD");
+
+  if (p == CNIL || *p == '\0') return;
+  if ((rec_fp = fopen(p, "wb")) == NULL) return;
+  rec_head = rec_tail = 0;
+  rec_done = false;
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  /* the writer waits on rec_wake, so it must exist before the thread */
+  if ((rec_wake = CreateEvent(NULL, FALSE, FALSE, NULL)) == NULL)
+  {
+    (void) fclose(rec_fp);
+    rec_fp = NULL;
+    return;
+  }
+  InitializeCriticalSection(&rec_lock);
+  if ((rec_thread = CreateThread(NULL, 0, rec_writer, NULL, 0, NULL)) == NULL)
+  {
+    DeleteCriticalSection(&rec_lock);
+    (void) CloseHandle(rec_wake);
+    (void) fclose(rec_fp);
+    rec_fp = NULL;
+    return;
+  }
+#else
+  if (pthread_create(&rec_thread, NULL, rec_writer, NULL) != 0)
+  {
+    (void) fclose(rec_fp);
+    rec_fp = NULL;
+    return;
+  }
+#endif
+  /* if nothing would finish the recording at exit, stop the writer now */
+  if (atexit(record_close) != 0) record_close();
+}
+
+/* Returns true if a recording is in progress */
+bool record_active()
+{
+  return rec_fp != NULL;
+}
+
+/* Stamp a frame with the current time and queue it for the writer thread.
+   Never waits for the disk: returns false if the frame had to be dropped
+   because the ring is full, in which case the next frame should redraw
+   the whole screen. */
+bool record_frame(char const *buf, const int len)
+{
+  char hdr[REC_HEADER_SIZE];
+  int32u head, tail, need;
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  FILETIME ft;
+  unsigned __int64 t;
+#else
+  struct timeval tv;
+#endif
+
+  if (rec_fp == NULL || len <= 0) return true;
+  if (rec_busy) return false;
+  rec_busy = 1;
+
+  need = REC_HEADER_SIZE + (int32u)len;
+  REC_LOCK();
+  head = rec_head;
+  tail = rec_tail;
+  REC_UNLOCK();
+  if (need > REC_RING_SIZE - (head - tail))
+  {
+    rec_busy = 0;
+    return false;
+  }
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  /* 100ns ticks since 1601, converted to the Unix epoch */
+  GetSystemTimeAsFileTime(&ft);
+  t = ((unsigned __int64)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+  t = t / 10 - 11644473600000000ULL;
+  rec_put32(&hdr[0], (int32u)(t / 1000000));
+  rec_put32(&hdr[4], (int32u)(t % 1000000));
+#else
+  (void) gettimeofday(&tv, NULL);
+  rec_put32(&hdr[0], (int32u)tv.tv_sec);
+  rec_put32(&hdr[4], (int32u)tv.tv_usec);
+#endif
+  rec_put32(&hdr[8], (int32u)len);
+
+  /* only the game writes past rec_head, so no lock is needed to copy */
+  rec_copy_in(head, hdr, REC_HEADER_SIZE);
+  rec_copy_in(head + REC_HEADER_SIZE, buf, (int32u)len);
+  REC_LOCK();
+  rec_head = head + need;
+  rec_signal();
+  REC_UNLOCK();
+  rec_busy = 0;
+  return true;
+}
+
+/* Write out anything still queued and finish the recording.  If the game
+   is being ended by a signal that arrived inside record_frame(), the lock
+   may be held, so the recording is left for the exit to close. */
+void record_close()
+{
+  if (rec_fp == NULL || rec_busy) return;
+  REC_LOCK();
+  rec_done = true;
+  rec_signal();
+  REC_UNLOCK();
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  (void) WaitForSingleObject(rec_thread, INFINITE);
+  (void) CloseHandle(rec_thread);
+  (void) CloseHandle(rec_wake);
+  DeleteCriticalSection(&rec_lock);
+#else
+  (void) pthread_join(rec_thread, NULL);
+#endif
+  (void) fclose(rec_fp);
+  rec_fp = NULL;
+}
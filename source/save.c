@@ -55,6 +55,23 @@ static void   rdn_int16u(FILE *, int8u *const, int16u *const, const int);
 static void   rd_item(FILE *, int8u *const, inven_type *const);
 static void   rd_monster(FILE *, int8u *const, monster_type *const);
 
+/* map coordinates and the indices kept in the cave are a byte, or two in
+   the large dungeon build; the end of a list of squares is marked with a
+   row that can not be valid */
+#ifdef LARGE_DUNGEON
+#define wr_dcoord wr_int16u
+#define rd_dcoord rd_int16u
+#define DCOORD_END 0xFFFF
+#define wr_dindex wr_int16u
+#define rd_dindex rd_int16u
+#else
+#define wr_dcoord wr_int8u
+#define rd_dcoord rd_int8u
+#define DCOORD_END 0xFF
+#define wr_dindex wr_int8u
+#define rd_dindex rd_int8u
+#endif
+
 /* these are used for the save file, to avoid having to pass them to every
    procedure */
 static bool from_savefile = false;  /* can overwrite old savefile when save */
@@ -69,9 +86,9 @@ static int32u start_time;  /* time that play started */
 
 static bool sv_write(FILE* file_ptr, int8u *const xor_byte)
 {
-  int32u int32u_tmp;
+  int32u int32u_tmp, l;
   register int i, j;
-  int count;
+  int count, msg_text, msg_count;
   int8u char_tmp, prev_char;
   register cave_type *c_ptr;
   register recall_type *r_ptr;
@@ -124,6 +141,12 @@ static bool sv_write(FILE* file_ptr, int8u *const xor_byte)
   if (find_ignore_doors)   int32u_tmp |= SV_FIND_IGNORE_DOORS;
   if (sound_beep_flag)     int32u_tmp |= SV_SOUND_BEEP_FLAG;
   if (display_counts)      int32u_tmp |= SV_DISPLAY_COUNTS;
+  if (skip_anim_flag)      int32u_tmp |= SV_SKIP_ANIM;
+  if (smart_path_flag)     int32u_tmp |= SV_SMART_PATH;
+  if (lazy_store_flag)     int32u_tmp |= SV_LAZY_STORES;
+#ifdef LARGE_DUNGEON
+  int32u_tmp |= SV_LARGE_DUNGEON;
+#endif
   if (total_winner)        int32u_tmp |= SV_TOTAL_WINNER;
   if (death)               int32u_tmp |= SV_DEATH;
 
@@ -240,9 +263,17 @@ static bool sv_write(FILE* file_ptr, int8u *const xor_byte)
   wrn_int8u(file_ptr, xor_byte, object_ident, OBJECT_IDENT_SIZE);
   wr_int32u(file_ptr, xor_byte, randes_seed);
   wr_int32u(file_ptr, xor_byte, town_seed);
-  wr_int16u(file_ptr, xor_byte, (int16u)last_msg);
-  for (i = 0; i < MAX_SAVE_MSG; i++)
-    wr_string(file_ptr, xor_byte, old_msg[i]);
+  /* the message log: its different texts, then its entries */
+  wr_int32u(file_ptr, xor_byte, msglog_texts());
+  for (l = 0; l < msglog_texts(); l++)
+    wr_string(file_ptr, xor_byte, msglog_text(l));
+  wr_int32u(file_ptr, xor_byte, msglog_size());
+  for (l = 0; l < msglog_size(); l++)
+  {
+    msglog_entry(l, &msg_text, &msg_count);
+    wr_int16u(file_ptr, xor_byte, (int16u)msg_text);
+    wr_int16u(file_ptr, xor_byte, (int16u)msg_count);
+  }
 
   /* this indicates 'cheating' if it is a one */
   wr_int16u (file_ptr, xor_byte, (int16u)panic_save);
@@ -301,8 +332,10 @@ static bool sv_write(FILE* file_ptr, int8u *const xor_byte)
   wr_int16u(file_ptr, xor_byte, (int16u)mon_tot_mult);
   wr_int16u(file_ptr, xor_byte, (int16u)cur_height);
   wr_int16u(file_ptr, xor_byte, (int16u)cur_width);
-  wr_int16u(file_ptr, xor_byte, (int16u)max_panel_rows);
-  wr_int16u(file_ptr, xor_byte, (int16u)max_panel_cols);
+  /* the panel limits used to be saved here, but now depend on the size
+     of the view */
+  wr_int16u(file_ptr, xor_byte, 0);
+  wr_int16u(file_ptr, xor_byte, 0);
 
   for (i = 0; i < MAX_HEIGHT; i++)
   {
@@ -310,24 +343,24 @@ static bool sv_write(FILE* file_ptr, int8u *const xor_byte)
     {
       c_ptr = &cave[i][j];
       if (!(c_ptr->cptr)) continue;
-      wr_int8u(file_ptr, xor_byte, (int8u)i);
-      wr_int8u(file_ptr, xor_byte, (int8u)j);
-      wr_int8u(file_ptr, xor_byte, c_ptr->cptr);
+      wr_dcoord(file_ptr, xor_byte, (dcoord)i);
+      wr_dcoord(file_ptr, xor_byte, (dcoord)j);
+      wr_dindex(file_ptr, xor_byte, c_ptr->cptr);
     }
   }
-  wr_int8u(file_ptr, xor_byte, (int8u)0xFF); /* marks end of cptr info */
+  wr_dcoord(file_ptr, xor_byte, DCOORD_END); /* marks end of cptr info */
   for (i = 0; i < MAX_HEIGHT; i++)
   {
     for (j = 0; j < MAX_WIDTH; j++)
     {
       c_ptr = &cave[i][j];
       if (!(c_ptr->tptr)) continue;
-      wr_int8u(file_ptr, xor_byte, (int8u)i);
-      wr_int8u(file_ptr, xor_byte, (int8u)j);
-      wr_int8u(file_ptr, xor_byte, c_ptr->tptr);
+      wr_dcoord(file_ptr, xor_byte, (dcoord)i);
+      wr_dcoord(file_ptr, xor_byte, (dcoord)j);
+      wr_dindex(file_ptr, xor_byte, c_ptr->tptr);
     }
   }
-  wr_int8u(file_ptr, xor_byte, (int8u)0xFF); /* marks end of tptr info */
+  wr_dcoord(file_ptr, xor_byte, DCOORD_END); /* marks end of tptr info */
   /* must set counter to zero, note that code may write out two bytes
      unnecessarily */
   count = 0;
@@ -336,12 +369,11 @@ static bool sv_write(FILE* file_ptr, int8u *const xor_byte)
   {
     for (j = 0; j < MAX_WIDTH; j++)
     {
-      c_ptr = &cave[i][j];
-      char_tmp = c_ptr->fval
-              | (c_ptr->lr << 4)
-              | (c_ptr->fm << 5)
-              | (c_ptr->pl << 6)
-              | (c_ptr->tl << 7);
+      char_tmp = cave[i][j].fval
+              | (cave_flag(cave_lr, i, j) << 4)
+              | (cave_flag(cave_fm, i, j) << 5)
+              | (cave_flag(cave_pl, i, j) << 6)
+              | (cave_flag(cave_tl, i, j) << 7);
       if (char_tmp != prev_char || count == MAX_UCHAR)
       {
         wr_int8u(file_ptr, xor_byte, (int8u)count);
@@ -385,9 +417,16 @@ static bool sv_write(FILE* file_ptr, int8u *const xor_byte)
 bool save_char()
 {
   vtype temp;
-  /* attempt to save until success or player abort */
-  while (!_save_char(savefile))
+  bool saved;
+
+  /* attempt to save until success or player abort; only the attempts are
+     profiled, not the time spent waiting on the player in between */
+  for (;;)
   {
+    PROF_ENTER(PROF_SAVE_CHAR);
+    saved = _save_char(savefile);
+    PROF_LEAVE(PROF_SAVE_CHAR);
+    if (saved) return true;
     sprintf(temp, "Save file '%s' create/overwrite failed.", savefile);
     msg_print(temp);
     /* this used to let the user try to delete the file, but that's
@@ -401,7 +440,6 @@ bool save_char()
     sprintf(temp, "Okay, retrying save with file '%s'...", savefile);
     prt(temp, 0, 0);
   }
-  return true;
 }
 
 bool _save_char(char const *const fnam)
@@ -414,6 +452,8 @@ bool _save_char(char const *const fnam)
 
   if (character_saved) return true; /* Nothing to save. */
 
+  store_catch_up();                 /* Put off store turnovers aren't saved */
+
   nosignals();
   put_qio();
   disturb(1, 0);                    /* Turn off resting and searching. */
@@ -475,6 +515,32 @@ bool _save_char(char const *const fnam)
   return true;
 }
 
+/* Save the game without ending it, so that the crash recovery journal has
+   a starting point */
+bool checkpoint_char()
+{
+  int32 saved_turn;
+  int heavy = pack_heavy;
+  bool saved;
+
+  /* a new character has not had a turn yet, but a savefile with a negative
+     turn count only holds the monster memory */
+  if (turn < 0) turn = 0;
+  saved_turn = turn;
+  saved = _save_char(savefile);
+  /* _save_char() takes the pack weight off the speed, as get_char() puts
+     it back with check_strength(); put it back here too, quietly, so that
+     the game carries on at the speed a replay from this savefile has */
+  change_speed(heavy);
+  pack_heavy = heavy;
+  if (!saved) return false;
+  character_saved = 0;
+  turn = saved_turn;
+  /* the savefile is ours now, so later saves may overwrite it */
+  from_savefile = true;
+  return true;
+}
+
 /* true if left version is less/older than right version */
 bool ver_lt(
   const int8u lmaj, const int8u lmin, const int8u lpat,
@@ -512,16 +578,19 @@ bool get_char(int *generate)
   int8u xor_byte = 0;
   register int i, j;
   int c, ok, total_count;
-  int32u int32u_tmp, age, time_saved;
+  int32u int32u_tmp, age, time_saved, l;
+  int msg_text, msg_count;
   vtype temp;
+  vtype old_msg[MAX_SAVE_MSG];
   int16u int16u_tmp;
-  register cave_type *c_ptr;
   register recall_type *r_ptr;
   struct misc *m_ptr;
   struct stats *s_ptr;
   register struct flags *f_ptr;
   store_type *st_ptr;
-  int8u char_tmp, ychar, xchar, count;
+  int8u char_tmp, count;
+  dcoord ychar, xchar;
+  dindex index_tmp;
   int8u version_maj, version_min, patch_level;
   bool dead_save, winner_save;
 #ifdef MSDOS
@@ -597,6 +666,23 @@ bool get_char(int *generate)
     }
     int32u_tmp = rd_int32u(file_ptr, &xor_byte);
 
+    /* the large dungeon build stores map coordinates in two bytes rather
+       than one, so neither build can read the other's savefiles */
+#ifdef LARGE_DUNGEON
+    if (!(int32u_tmp & SV_LARGE_DUNGEON))
+    {
+      prt("Sorry. This savefile is from the normal build, not the large "
+          "dungeon one.", 2, 0);
+      goto error;
+    }
+#else
+    if (int32u_tmp & SV_LARGE_DUNGEON)
+    {
+      prt("Sorry. This savefile is from the large dungeon build.", 2, 0);
+      goto error;
+    }
+#endif
+
     find_cut            = !!(int32u_tmp & SV_FIND_CUT);
     find_examine        = !!(int32u_tmp & SV_FIND_EXAMINE);
     find_prself         = !!(int32u_tmp & SV_FIND_PRSELF);
@@ -616,6 +702,9 @@ bool get_char(int *generate)
     display_counts      = !!(int32u_tmp & SV_DISPLAY_COUNTS) ||
                           ver_lt(version_maj, version_min, patch_level,
                                  5, 2, 2);
+    skip_anim_flag      = !!(int32u_tmp & SV_SKIP_ANIM);
+    smart_path_flag     = !!(int32u_tmp & SV_SMART_PATH);
+    lazy_store_flag     = !!(int32u_tmp & SV_LAZY_STORES);
     dead_save           = !!(int32u_tmp & SV_DEATH);
     winner_save         = !!(int32u_tmp & SV_TOTAL_WINNER);
 
@@ -746,9 +835,38 @@ bool get_char(int *generate)
       rdn_int8u(file_ptr, &xor_byte, object_ident, OBJECT_IDENT_SIZE);
       randes_seed     = rd_int32u(file_ptr, &xor_byte);
       town_seed       = rd_int32u(file_ptr, &xor_byte);
-      last_msg        = (int16)rd_int16u(file_ptr, &xor_byte);
-      for (i = 0; i < MAX_SAVE_MSG; i++)
-        rd_string(file_ptr, &xor_byte, old_msg[i]);
+      msglog_clear();
+      if (ver_ge(version_maj, version_min, patch_level, 6, 0, 1))
+      {
+        int32u_tmp = rd_int32u(file_ptr, &xor_byte);
+        if (int32u_tmp > MSG_LOG_TEXTS) goto error;
+        for (l = 0; l < int32u_tmp; l++)
+        {
+          rd_string(file_ptr, &xor_byte, temp);
+          if (msglog_intern(temp) != (int)l) goto error;
+        }
+        int32u_tmp = rd_int32u(file_ptr, &xor_byte);
+        for (l = 0; l < int32u_tmp; l++)
+        {
+          msg_text  = rd_int16u(file_ptr, &xor_byte);
+          msg_count = rd_int16u(file_ptr, &xor_byte);
+          if (!msglog_append(msg_text, msg_count)) goto error;
+        }
+      }
+      else
+      {
+        /* older savefiles keep the last MAX_SAVE_MSG messages in a ring,
+           with the latest at the index written first */
+        int16u_tmp = rd_int16u(file_ptr, &xor_byte);
+        if (int16u_tmp >= MAX_SAVE_MSG) goto error;
+        for (i = 0; i < MAX_SAVE_MSG; i++)
+          rd_string(file_ptr, &xor_byte, old_msg[i]);
+        for (i = 1; i <= MAX_SAVE_MSG; i++)
+        {
+          j = (int16u_tmp + i) % MAX_SAVE_MSG;
+          if (old_msg[j][0] != '\0') msglog_add(old_msg[j]);
+        }
+      }
 
       int16u_tmp   = rd_int16u(file_ptr, &xor_byte);
       panic_save   = !!int16u_tmp;
@@ -782,7 +900,7 @@ bool get_char(int *generate)
         time_saved = rd_int32u(file_ptr, &xor_byte);
 
       if (ver_ge(version_maj, version_min, patch_level, 5, 2, 0))
-        rd_string(file_ptr, died_from, &xor_byte);
+        rd_string(file_ptr, &xor_byte, died_from);
 
       max_score = 0;
       if (ver_ge(version_maj, version_min, patch_level, 5, 2, 2))
@@ -842,48 +960,47 @@ bool get_char(int *generate)
     mon_tot_mult   = (int16)rd_int16u(file_ptr, &xor_byte);
     cur_height     = (int16)rd_int16u(file_ptr, &xor_byte);
     cur_width      = (int16)rd_int16u(file_ptr, &xor_byte);
-    max_panel_rows = (int16)rd_int16u(file_ptr, &xor_byte);
-    max_panel_cols = (int16)rd_int16u(file_ptr, &xor_byte);
+    (void) rd_int16u(file_ptr, &xor_byte); /* the old panel limits */
+    (void) rd_int16u(file_ptr, &xor_byte);
 
     /* read in the creature ptr info */
-    for (char_tmp = rd_int8u(file_ptr, &xor_byte);
-         char_tmp != 0xFF;
-         char_tmp = rd_int8u(file_ptr, &xor_byte))
+    for (ychar = rd_dcoord(file_ptr, &xor_byte);
+         ychar != DCOORD_END;
+         ychar = rd_dcoord(file_ptr, &xor_byte))
     {
-      ychar    = char_tmp;
-      xchar    = rd_int8u(file_ptr, &xor_byte);
-      char_tmp = rd_int8u(file_ptr, &xor_byte);
-      if (xchar > MAX_WIDTH || ychar > MAX_HEIGHT) goto error;
-      cave[ychar][xchar].cptr = char_tmp;
+      xchar     = rd_dcoord(file_ptr, &xor_byte);
+      index_tmp = rd_dindex(file_ptr, &xor_byte);
+      if (xchar >= MAX_WIDTH || ychar >= MAX_HEIGHT) goto error;
+      cave[ychar][xchar].cptr = index_tmp;
     }
     /* read in the treasure ptr info */
-    for (char_tmp = rd_int8u(file_ptr, &xor_byte);
-         char_tmp != 0xFF;
-         char_tmp = rd_int8u(file_ptr, &xor_byte))
+    for (ychar = rd_dcoord(file_ptr, &xor_byte);
+         ychar != DCOORD_END;
+         ychar = rd_dcoord(file_ptr, &xor_byte))
     {
-      ychar    = char_tmp;
-      xchar    = rd_int8u(file_ptr, &xor_byte);
-      char_tmp = rd_int8u(file_ptr, &xor_byte);
-      if (xchar > MAX_WIDTH || ychar > MAX_HEIGHT) goto error;
-      cave[ychar][xchar].tptr = char_tmp;
+      xchar     = rd_dcoord(file_ptr, &xor_byte);
+      index_tmp = rd_dindex(file_ptr, &xor_byte);
+      if (xchar >= MAX_WIDTH || ychar >= MAX_HEIGHT || index_tmp >= MAX_TALLOC)
+        goto error;
+      set_tptr(ychar, xchar, index_tmp);
     }
     /* read in the rest of the cave info */
-    c_ptr = &cave[0][0];
     for (total_count = 0;
          total_count < MAX_HEIGHT*MAX_WIDTH;
          total_count += count)
     {
       count    = rd_int8u(file_ptr, &xor_byte);
       char_tmp = rd_int8u(file_ptr, &xor_byte);
-      for (i = 0; i < count; ++i)
+      if (total_count + count > MAX_HEIGHT*MAX_WIDTH) goto error;
+      for (i = total_count; i < total_count + count; ++i)
       {
-        if (c_ptr >= &cave[MAX_HEIGHT][0]) goto error;
-        c_ptr->fval =  char_tmp       & 0xF; /* bits 0-3 */
-        c_ptr->lr   = (char_tmp >> 4) & 0x1; /* bit 4 */
-        c_ptr->fm   = (char_tmp >> 5) & 0x1; /* bit 5 */
-        c_ptr->pl   = (char_tmp >> 6) & 0x1; /* bit 6 */
-        c_ptr->tl   = (char_tmp >> 7) & 0x1; /* bit 7 */
-        c_ptr++;
+        ychar = (dcoord)(i / MAX_WIDTH);
+        xchar = (dcoord)(i % MAX_WIDTH);
+        cave[ychar][xchar].fval = char_tmp & 0xF; /* bits 0-3 */
+        cave_put(cave_lr, ychar, xchar, (char_tmp >> 4) & 0x1); /* bit 4 */
+        cave_put(cave_fm, ychar, xchar, (char_tmp >> 5) & 0x1); /* bit 5 */
+        cave_put(cave_pl, ychar, xchar, (char_tmp >> 6) & 0x1); /* bit 6 */
+        cave_put(cave_tl, ychar, xchar, (char_tmp >> 7) & 0x1); /* bit 7 */
       }
     }
 
@@ -990,6 +1107,9 @@ closefiles:
         age = (start_time < time_saved) ? 0 : start_time - time_saved;
         age = (age + 43200L) / 86400L;  /* age in days, rounded */
         if (age > 10) age = 10; /* in case savefile is very old */
+        /* but not if the game is about to be recovered from the journal,
+           which has to start from exactly what was saved */
+        if (journal_pending()) age = 0;
         for (i = 0; i < age; i++) store_maint();
       }
 
@@ -1119,9 +1239,9 @@ static void wr_monster(FILE *fp, int8u *const xb,
   wr_int16u(fp, xb, (int16u)mon->csleep);
   wr_int16u(fp, xb, (int16u)mon->cspeed);
   wr_int16u(fp, xb, mon->mptr);
-  wr_int8u (fp, xb, mon->fy);
-  wr_int8u (fp, xb, mon->fx);
-  wr_int8u (fp, xb, mon->cdis);
+  wr_dcoord(fp, xb, mon->fy);
+  wr_dcoord(fp, xb, mon->fx);
+  wr_dcoord(fp, xb, mon->cdis);
   wr_int8u (fp, xb, mon->ml);
   wr_int8u (fp, xb, mon->stunned);
   wr_int8u (fp, xb, mon->confused);
@@ -1215,12 +1335,13 @@ static void rd_monster(FILE *fp, int8u *const xb, monster_type *const mon)
   mon->csleep   = (int16)rd_int16u(fp, xb);
   mon->cspeed   = (int16)rd_int16u(fp, xb);
   mon->mptr     = rd_int16u(fp, xb);
-  mon->fy       = rd_int8u(fp, xb);
-  mon->fx       = rd_int8u(fp, xb);
-  mon->cdis     = rd_int8u(fp, xb);
+  mon->fy       = rd_dcoord(fp, xb);
+  mon->fx       = rd_dcoord(fp, xb);
+  mon->cdis     = rd_dcoord(fp, xb);
   mon->ml       = rd_int8u(fp, xb);
   mon->stunned  = rd_int8u(fp, xb);
   mon->confused = rd_int8u(fp, xb);
+  cache_monster(mon);
 }
 
 /* functions called from death.c to implement the score file */
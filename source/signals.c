@@ -38,10 +38,49 @@
 #include <stdio.h>
 #include <stdlib.h> /* exit() */
 #include <string.h>
+#ifdef _MSC_VER
+# include <io.h>     /* write() */
+#else
+# include <unistd.h> /* write(), _exit() */
+#endif
 
 static int error_sig = -1;
 static int signal_count = 0;
 
+static char const bug_msg[] = "\r\nOH NO!!!!!!  A gruesome software bug "
+  "LEAPS out at you. There is NO defense!\r\n";
+static char const restore_msg[] = "\r\nOH NO!!!!!!  A gruesome software "
+  "bug LEAPS out at you.\r\nYour guardian angel will restore you when you "
+  "return.\r\n";
+
+/* Returns true if the signal means the game itself went wrong, rather
+   than that it was told to stop from outside */
+static bool fault_signal(int sig)
+{
+  switch (sig)
+  {
+  case SIGILL:
+  case SIGFPE:
+  case SIGSEGV:
+  case SIGABRT:
+#ifdef SIGBUS
+  case SIGBUS:
+#endif
+#ifdef SIGSYS
+  case SIGSYS:
+#endif
+#ifdef SIGTRAP
+  case SIGTRAP:
+#endif
+#ifdef SIGEMT
+  case SIGEMT:
+#endif
+    return true;
+  default:
+    return false;
+  }
+}
+
 static void signal_handler(int sig)
 {
   if (error_sig >= 0) /* Ignore all second signals. */
@@ -87,29 +126,20 @@ static void signal_handler(int sig)
     death = true;
     exit_game();
   }
-  /* Die. */
-  prt(
-    "OH NO!!!!!!  A gruesome software bug LEAPS out at you. There is NO defense!",
-    23, 0);
-  if (!death && !character_saved && character_generated)
-  {
-    panic_save = true;
-    prt("Your guardian angel is trying to save you.", 0, 0);
-    sprintf(died_from,"(panic save %d)",sig);
-    if (!save_char())
-    {
-      strcpy(died_from, "software bug");
-      death = true;
-      turn = -1;
-    }
-  }
+  /* Die.  Nothing here may save the game, print through curses or
+     restore the terminal, since none of that is safe from inside a signal
+     handler; only write() the journal out, so that replaying it on
+     restart recovers the game, up to the command that crashed it if it
+     crashed. */
+  if (!death && !character_saved && character_generated
+      && (fault_signal(sig) ? journal_crash() : journal_sync()))
+    (void) write(1, restore_msg, sizeof(restore_msg) - 1);
   else
-  {
-    death = true;
-    _save_char(savefile);  /* Quietly save the memory anyway. */
-  }
-  restore_term();
-  exit(1);
+    (void) write(1, bug_msg, sizeof(bug_msg) - 1);
+  /* not exit(), which would run the atexit() handlers that shut down the
+     recorder, spectator and event log threads; those take locks the game
+     may have been holding when it crashed */
+  _exit(1);
 }
 
 void nosignals()
@@ -0,0 +1,330 @@
+/* source/spectate.c: live broadcast of the game screen to spectators
+
+   Every time the output layer flushes the screen, the changes since the
+   previous frame are encoded exactly once, as ANSI cursor positioning
+   sequences plus UTF-8 text, and appended to a ring buffer that lives in a
+   shared file named by the MORIA_SPECTATE environment variable.  Viewers
+   only ever read that file (see spectate_view()), at their own pace, so the
+   cost to the game is the same for one spectator as for a thousand, and a
+   slow viewer can never stall the game.
+
+   File layout: a SPEC_HEADER_SIZE byte header, followed by SPEC_RING_SIZE
+   bytes of ring data.  The header holds a magic string, the total number of
+   bytes ever written to the stream (head), the stream offset of the most
+   recent keyframe, and a flag that is cleared when the game exits.  Stream
+   offset n is stored at ring index n % SPEC_RING_SIZE.  All offsets are
+   32 bit and only ever compared by difference, so they may wrap.
+
+   The writer updates the ring data before the header, so the frame it is
+   writing, which may be up to SPEC_FRAME_MAX bytes long, can be
+   overwriting anything more than SPEC_SAFE bytes behind the head the
+   header shows.  A viewer only trusts what it read if that data is still
+   within SPEC_SAFE bytes of the head once it has finished reading.  The
+   writer starts a new keyframe (clear screen plus full redraw) before the
+   previous one is half a ring old, so a viewer that falls too far behind
+   can always drop what it missed and resume from the latest keyframe. */
+
+#include "config.h"
+
+#if defined(_MSC_VER) || defined(__MINGW32__) /* Windows */
+# ifdef _MSC_VER /* Visual Studio */
+#  include <curses.h>
+# else
+#  include <pdcurses.h> /* MinGW32 etc. */
+# endif
+# include "cp437utf.h"
+#else /* everything else (*nix etc.) */
+# include <ncurses.h>
+#endif
+
+#include "externs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SPEC_MAGIC       "HZMSPEC2"
+#define SPEC_MAGIC_SIZE  8
+#define SPEC_HEADER_SIZE (SPEC_MAGIC_SIZE + 4 + 4 + 1)
+#define SPEC_RING_SIZE   262144L
+
+/* the largest screen the game uses: the biggest map view, plus the message
+   and status lines and the stat block */
+#define SPEC_ROWS (VIEW_MAX_HEIGHT + 2)
+#define SPEC_COLS (VIEW_MAX_WIDTH + 13)
+
+/* worst case size of one encoded frame: clear screen, then a cursor
+   position sequence and up to 3 UTF-8 bytes per cell for every row, then
+   the final cursor position; plus slack for ToUTF8Row() */
+#define SPEC_FRAME_MAX (16 + SPEC_ROWS * (12 + 3 * SPEC_COLS) + 12 + 4)
+/* how far behind the published head data is safe from a frame that is
+   being written */
+#define SPEC_SAFE ((int32u)(SPEC_RING_SIZE - SPEC_FRAME_MAX))
+
+static FILE *spec_fp = NULL;
+static int32u spec_head;     /* bytes written to the stream so far   */
+static int32u spec_key;      /* stream offset of the latest keyframe */
+static bool spec_need_key = true; /* next frame must be a keyframe   */
+static int spec_cur_y, spec_cur_x;
+/* screen contents as last sent to viewers */
+static chtype spec_shadow[SPEC_ROWS][SPEC_COLS];
+static char spec_frame[SPEC_FRAME_MAX];
+
+static void spec_put32(unsigned char *p, const int32u v)
+{
+  p[0] = (unsigned char)(v & 0xFF);
+  p[1] = (unsigned char)((v >> 8) & 0xFF);
+  p[2] = (unsigned char)((v >> 16) & 0xFF);
+  p[3] = (unsigned char)((v >> 24) & 0xFF);
+}
+
+static int32u spec_get32(unsigned char const *p)
+{
+  return (int32u)p[0] | ((int32u)p[1] << 8) | ((int32u)p[2] << 16)
+       | ((int32u)p[3] << 24);
+}
+
+static void spec_write_header(const bool live)
+{
+  unsigned char hdr[SPEC_HEADER_SIZE];
+
+  memcpy(hdr, SPEC_MAGIC, SPEC_MAGIC_SIZE);
+  spec_put32(&hdr[SPEC_MAGIC_SIZE], spec_head);
+  spec_put32(&hdr[SPEC_MAGIC_SIZE + 4], spec_key);
+  hdr[SPEC_MAGIC_SIZE + 8] = live ? 1 : 0;
+  /* the seek also pushes any buffered ring data out ahead of the header */
+  (void) fseek(spec_fp, 0L, SEEK_SET);
+  (void) fwrite(hdr, 1, SPEC_HEADER_SIZE, spec_fp);
+  (void) fflush(spec_fp);
+}
+
+/* Append an encoded frame to the ring, then publish it via the header */
+static void spec_append(char const *buf, const int32u len)
+{
+  int32u off = spec_head % SPEC_RING_SIZE;
+  int32u n = SPEC_RING_SIZE - off;
+
+  if (n > len) n = len;
+  (void) fseek(spec_fp, SPEC_HEADER_SIZE + (long)off, SEEK_SET);
+  (void) fwrite(buf, 1, n, spec_fp);
+  if (n < len)
+  {
+    (void) fseek(spec_fp, SPEC_HEADER_SIZE, SEEK_SET);
+    (void) fwrite(buf + n, 1, len - n, spec_fp);
+  }
+  spec_head += len;
+  spec_write_header(true);
+}
+
+/* Encode a run of screen cells as UTF-8, returns the number of bytes */
+static int spec_encode(char *dst, chtype const *cells, const int len)
+{
+#if defined(PDC_WIDE)
+  /* cells already hold Unicode code points, see ToUTF() */
+  int i;
+  unsigned long c;
+  char *p = dst;
+
+  for (i = 0; i < len; i++)
+  {
+    c = cells[i];
+    if (c < 0x80)
+    {
+      *p++ = (char)c;
+    }
+    else if (c < 0x800)
+    {
+      *p++ = (char)(0xC0 | (c >> 6));
+      *p++ = (char)(0x80 | (c & 0x3F));
+    }
+    else
+    {
+      *p++ = (char)(0xE0 | (c >> 12));
+      *p++ = (char)(0x80 | ((c >> 6) & 0x3F));
+      *p++ = (char)(0x80 | (c & 0x3F));
+    }
+  }
+  return (int)(p - dst);
+#elif defined(_MSC_VER) || defined(__MINGW32__)
+  /* cells hold CP437 characters, so use the pre-encoded table */
+  int i;
+  unsigned char raw[SPEC_COLS];
+
+  for (i = 0; i < len; i++) raw[i] = (unsigned char)cells[i];
+  return ToUTF8Row(dst, raw, len);
+#else
+  /* cells are already in the terminal's character set */
+  int i;
+
+  for (i = 0; i < len; i++) dst[i] = (char)cells[i];
+  return len;
+#endif
+}
+
+/* Start broadcasting if MORIA_SPECTATE names a file to broadcast to */
+void spectate_init()
+{
+  char *p = getenv("MORIA_SPECTATE");
+
+  if (p == CNIL || *p == '\0') return;
+  if ((spec_fp = fopen(p, "w+b")) == NULL) return;
+  spec_head = 0;
+  spec_key = 0;
+  spec_need_key = true;
+  spec_write_header(true);
+  (void) atexit(spectate_close);
+}
+
+/* Encode what changed on the screen since the last frame, once, and make
+   it available to all viewers and to the session recorder. Must be called
+   before the screen is refreshed, as it uses the curses touched-line
+   information. */
+void spectate_frame()
+{
+  chtype cells[SPEC_COLS + 1];
+  char *p;
+  int row, col, first, last, y, x;
+  bool key;
+
+  if (spec_fp == NULL && !record_active()) return;
+
+  key = spec_need_key;
+  p = spec_frame;
+  if (key)
+  {
+    /* viewers start over from a blank screen */
+    p += sprintf(p, "\033[H\033[2J");
+    for (row = 0; row < SPEC_ROWS; row++)
+      for (col = 0; col < SPEC_COLS; col++)
+        spec_shadow[row][col] = ' ';
+    spec_cur_y = spec_cur_x = -1;
+  }
+
+  getyx(stdscr, y, x);
+  for (row = 0; row < SPEC_ROWS && row < LINES; row++)
+  {
+    if (!key && !is_linetouched(stdscr, row)) continue;
+    /* the returned row is null terminated, but may be short */
+    if (mvwinchnstr(stdscr, row, 0, cells, SPEC_COLS) == ERR) cells[0] = 0;
+    for (col = 0; col < SPEC_COLS && cells[col] != 0; col++)
+      cells[col] &= A_CHARTEXT;
+    for (; col < SPEC_COLS; col++)
+      cells[col] = ' ';
+    /* only send the span between the first and last changed cells */
+    for (first = 0; first < SPEC_COLS; first++)
+      if (cells[first] != spec_shadow[row][first]) break;
+    if (first == SPEC_COLS) continue;
+    for (last = SPEC_COLS - 1; last > first; last--)
+      if (cells[last] != spec_shadow[row][last]) break;
+    p += sprintf(p, "\033[%d;%dH", row + 1, first + 1);
+    p += spec_encode(p, &cells[first], last - first + 1);
+    memcpy(&spec_shadow[row][first], &cells[first],
+           (last - first + 1) * sizeof(chtype));
+  }
+  (void) wmove(stdscr, y, x);
+
+  if (p != spec_frame || y != spec_cur_y || x != spec_cur_x)
+  {
+    p += sprintf(p, "\033[%d;%dH", y + 1, x + 1);
+    spec_cur_y = y;
+    spec_cur_x = x;
+    if (key)
+    {
+      spec_key = spec_head;
+      spec_need_key = false;
+    }
+    /* a frame the recorder had to drop is made good by a full redraw */
+    if (!record_frame(spec_frame, (int)(p - spec_frame)))
+      spec_need_key = true;
+    if (spec_fp == NULL) return;
+    spec_append(spec_frame, (int32u)(p - spec_frame));
+    /* keep a keyframe within reach of viewers that fall behind */
+    if (spec_head - spec_key > SPEC_RING_SIZE / 2) spec_need_key = true;
+  }
+}
+
+/* Tell viewers that the broadcast is over */
+void spectate_close()
+{
+  if (spec_fp == NULL) return;
+  spec_write_header(false);
+  (void) fclose(spec_fp);
+  spec_fp = NULL;
+}
+
+/* Follow a broadcast in the file at path, copying it to standard output
+   until the game exits. This only reads the file, so any number of
+   viewers can follow the same game. */
+int spectate_view(char const *path)
+{
+  static char buf[SPEC_RING_SIZE];
+  unsigned char hdr[SPEC_HEADER_SIZE];
+  FILE *fp = NULL;
+  int32u pos = 0, head, key, len, off, n;
+  bool synced = false, live;
+
+  while (true)
+  {
+    if (fp == NULL && (fp = fopen(path, "rb")) == NULL)
+    {
+      /* game has not started broadcasting yet */
+      napms(250);
+      continue;
+    }
+    (void) fseek(fp, 0L, SEEK_SET);
+    if (fread(hdr, 1, SPEC_HEADER_SIZE, fp) != SPEC_HEADER_SIZE
+        || memcmp(hdr, SPEC_MAGIC, SPEC_MAGIC_SIZE) != 0)
+    {
+      napms(250);
+      continue;
+    }
+    head = spec_get32(&hdr[SPEC_MAGIC_SIZE]);
+    key  = spec_get32(&hdr[SPEC_MAGIC_SIZE + 4]);
+    live = hdr[SPEC_MAGIC_SIZE + 8] != 0;
+
+    /* new viewers, and viewers that fell too far behind, resume from the
+       latest keyframe */
+    if (!synced || head - pos > SPEC_SAFE)
+    {
+      pos = key;
+      synced = true;
+    }
+    len = head - pos;
+    if (len == 0)
+    {
+      if (!live) break;
+      napms(50);
+      continue;
+    }
+
+    off = pos % SPEC_RING_SIZE;
+    n = SPEC_RING_SIZE - off;
+    if (n > len) n = len;
+    (void) fseek(fp, SPEC_HEADER_SIZE + (long)off, SEEK_SET);
+    n = fread(buf, 1, n, fp);
+    if (n < len)
+    {
+      (void) fseek(fp, SPEC_HEADER_SIZE, SEEK_SET);
+      n += fread(buf + n, 1, len - n, fp);
+    }
+
+    /* if the writer came within a frame of lapping us while we were
+       reading, the frame it was writing may have torn the data, so throw
+       it away and resync */
+    (void) fseek(fp, 0L, SEEK_SET);
+    if (fread(hdr, 1, SPEC_HEADER_SIZE, fp) != SPEC_HEADER_SIZE
+        || spec_get32(&hdr[SPEC_MAGIC_SIZE]) - pos > SPEC_SAFE
+        || n != len)
+    {
+      synced = false;
+      continue;
+    }
+
+    (void) fwrite(buf, 1, len, stdout);
+    (void) fflush(stdout);
+    pos = head;
+  }
+
+  (void) fclose(fp);
+  return 0;
+}
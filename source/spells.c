@@ -34,10 +34,31 @@
 
 #if defined(LINT_ARGS)
 static void replace_spot(int, int, int);
+static void blast_init(void);
+static int blast_area(int, int, int *, int *, int *);
 #else
 static void replace_spot();
+static void blast_init();
+static int blast_area();
 #endif
 
+/* The squares within OBJ_BALL_RADIUS of the centre of an explosion, in the
+   order they are affected, each with its distance from the centre and the
+   squares in between that must be open for the explosion to reach it.
+   None of this depends on where the explosion is, so it is worked out once
+   instead of calling distance() and los() for every square every time. */
+#define BLAST_SIZE ((2*OBJ_BALL_RADIUS+1) * (2*OBJ_BALL_RADIUS+1))
+#define BLAST_PATH (2*OBJ_BALL_RADIUS)
+
+typedef struct blast_type
+{
+  int dy, dx, dis;
+  int len, path_y[BLAST_PATH], path_x[BLAST_PATH];
+} blast_type;
+
+static blast_type blast_mask[BLAST_SIZE];
+static int blast_num = 0;
+
 /* Following are spell procedure/functions			-RAK-	*/
 /* These routines are commonly used in the scroll, potion, wands, and	 */
 /* staves routines, and are occasionally called from other areas.	  */
@@ -72,7 +93,7 @@ int y, x;
   register int i, j;
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   int sleep;
   vtype out_val, m_name;
 
@@ -108,24 +129,26 @@ int y, x;
 }
 
 /* Detect any treasure on the current panel		-RAK-	*/
+/* The detection spells look through the objects on the level rather than
+   every square of the panel, see set_tptr().  Objects not in the dungeon
+   have no square pointing back at them, and are skipped. */
 int detect_treasure()
 {
-  register int i, j, detect;
-  register cave_type *c_ptr;
+  register int i, y, x, detect;
 
   detect = false;
-  for (i = panel_row_min; i <= panel_row_max; i++)
-    for (j = panel_col_min; j <= panel_col_max; j++)
-      {
-	c_ptr = &cave[i][j];
-	if ((c_ptr->tptr != 0) && (t_list[c_ptr->tptr].tval == TV_GOLD) &&
-	    !test_light(i, j))
-	  {
-	    c_ptr->fm = true;
-	    lite_spot(i, j);
-	    detect = true;
-	  }
-      }
+  for (i = MIN_TRIX; i < tcptr; i++)
+    {
+      y = t_row[i];
+      x = t_col[i];
+      if ((cave[y][x].tptr == i) && (t_list[i].tval == TV_GOLD) &&
+	  panel_contains(y, x) && !test_light(y, x))
+	{
+	  cave_on(cave_fm, y, x);
+	  lite_spot(y, x);
+	  detect = true;
+	}
+    }
   return(detect);
 }
 
@@ -133,22 +156,21 @@ int detect_treasure()
 /* Detect all objects on the current panel		-RAK-	*/
 int detect_object()
 {
-  register int i, j, detect;
-  register cave_type *c_ptr;
+  register int i, y, x, detect;
 
   detect = false;
-  for (i = panel_row_min; i <= panel_row_max; i++)
-    for (j = panel_col_min; j <= panel_col_max; j++)
-      {
-	c_ptr = &cave[i][j];
-	if ((c_ptr->tptr != 0) && (t_list[c_ptr->tptr].tval < TV_MAX_OBJECT)
-	    && !test_light(i, j))
-	  {
-	    c_ptr->fm = true;
-	    lite_spot(i, j);
-	    detect = true;
-	  }
-      }
+  for (i = MIN_TRIX; i < tcptr; i++)
+    {
+      y = t_row[i];
+      x = t_col[i];
+      if ((cave[y][x].tptr == i) && (t_list[i].tval < TV_MAX_OBJECT) &&
+	  panel_contains(y, x) && !test_light(y, x))
+	{
+	  cave_on(cave_fm, y, x);
+	  lite_spot(y, x);
+	  detect = true;
+	}
+    }
   return(detect);
 }
 
@@ -156,29 +178,25 @@ int detect_object()
 /* Locates and displays traps on current panel		-RAK-	*/
 int detect_trap()
 {
-  register int i, j;
+  register int i, y, x;
   int detect;
-  register cave_type *c_ptr;
-  register inven_type *t_ptr;
 
   detect = false;
-  for (i = panel_row_min; i <= panel_row_max; i++)
-    for (j = panel_col_min; j <= panel_col_max; j++)
-      {
-	c_ptr = &cave[i][j];
-	if (c_ptr->tptr != 0)
-	  if (t_list[c_ptr->tptr].tval == TV_INVIS_TRAP)
-	    {
-	      c_ptr->fm = true;
-	      change_trap(i, j);
-	      detect = true;
-	    }
-	  else if (t_list[c_ptr->tptr].tval == TV_CHEST)
-	    {
-	      t_ptr = &t_list[c_ptr->tptr];
-	      known2(t_ptr);
-	    }
-      }
+  for (i = MIN_TRIX; i < tcptr; i++)
+    {
+      y = t_row[i];
+      x = t_col[i];
+      if ((cave[y][x].tptr != i) || !panel_contains(y, x))
+	continue;
+      if (t_list[i].tval == TV_INVIS_TRAP)
+	{
+	  cave_on(cave_fm, y, x);
+	  change_trap(y, x);
+	  detect = true;
+	}
+      else if (t_list[i].tval == TV_CHEST)
+	known2(&t_list[i]);
+    }
   return(detect);
 }
 
@@ -186,32 +204,34 @@ int detect_trap()
 /* Locates and displays all secret doors on current panel -RAK-	*/
 int detect_sdoor()
 {
-  register int i, j, detect;
+  register int i, y, x, detect;
   register cave_type *c_ptr;
 
   detect = false;
-  for (i = panel_row_min; i <= panel_row_max; i++)
-    for (j = panel_col_min; j <= panel_col_max; j++)
-      {
-	c_ptr = &cave[i][j];
-	if (c_ptr->tptr != 0)
-	  /* Secret doors  */
-	  if (t_list[c_ptr->tptr].tval == TV_SECRET_DOOR)
-	    {
-	      c_ptr->fm = true;
-	      change_trap(i, j);
-	      detect = true;
-	    }
-	/* Staircases	 */
-	  else if (((t_list[c_ptr->tptr].tval == TV_UP_STAIR) ||
-		    (t_list[c_ptr->tptr].tval == TV_DOWN_STAIR)) &&
-		   !c_ptr->fm)
-	    {
-	      c_ptr->fm = true;
-	      lite_spot(i, j);
-	      detect = true;
-	    }
-      }
+  for (i = MIN_TRIX; i < tcptr; i++)
+    {
+      y = t_row[i];
+      x = t_col[i];
+      c_ptr = &cave[y][x];
+      if ((c_ptr->tptr != i) || !panel_contains(y, x))
+	continue;
+      /* Secret doors  */
+      if (t_list[i].tval == TV_SECRET_DOOR)
+	{
+	  cave_on(cave_fm, y, x);
+	  change_trap(y, x);
+	  detect = true;
+	}
+      /* Staircases	 */
+      else if (((t_list[i].tval == TV_UP_STAIR) ||
+		(t_list[i].tval == TV_DOWN_STAIR)) &&
+	       !cave_flag(cave_fm, y, x))
+	{
+	  cave_on(cave_fm, y, x);
+	  lite_spot(y, x);
+	  detect = true;
+	}
+    }
   return(detect);
 }
 
@@ -264,16 +284,14 @@ register int y, x;
   if (py.flags.blind < 1)
     msg_print("You are surrounded by a white light.");
   light = true;
-  if (cave[y][x].lr && (dun_level > 0))
+  if (cave_flag(cave_lr, y, x) && (dun_level > 0))
     light_room(y, x);
   /* Must always light immediate area, because one might be standing on
      the edge of a room, or next to a destroyed area, etc.  */
+  cave_fill(cave_pl, y-1, x-1, y+1, x+1, true);
   for (i = y-1; i <= y+1; i++)
     for (j = x-1; j <=  x+1; j++)
-      {
-	cave[i][j].pl = true;
-	lite_spot(i, j);
-      }
+      lite_spot(i, j);
   return(light);
 }
 
@@ -288,7 +306,7 @@ int y, x;
   register cave_type *c_ptr;
 
   unlight = false;
-  if (cave[y][x].lr && (dun_level > 0))
+  if (cave_flag(cave_lr, y, x) && (dun_level > 0))
     {
       tmp1 = (SCREEN_HEIGHT/2);
       tmp2 = (SCREEN_WIDTH /2);
@@ -301,9 +319,9 @@ int y, x;
 	  for (j = start_col; j <= end_col; j++)
 	    {
 	      c_ptr = &cave[i][j];
-	      if (c_ptr->lr && c_ptr->fval <= MAX_CAVE_FLOOR)
+	      if (cave_flag(cave_lr, i, j) && c_ptr->fval <= MAX_CAVE_FLOOR)
 		{
-		  c_ptr->pl = false;
+		  cave_off(cave_pl, i, j);
 		  c_ptr->fval = DARK_FLOOR;
 		  lite_spot (i, j);
 		  if (!test_light(i, j))
@@ -317,10 +335,10 @@ int y, x;
       for (j = x-1; j <= x+1; j++)
 	{
 	  c_ptr = &cave[i][j];
-	  if ((c_ptr->fval == CORR_FLOOR) && c_ptr->pl)
+	  if ((c_ptr->fval == CORR_FLOOR) && cave_flag(cave_pl, i, j))
 	    {
 	      /* pl could have been set by star-lite wand, etc */
-	      c_ptr->pl = false;
+	      cave_off(cave_pl, i, j);
 	      unlight = true;
 	    }
 	}
@@ -335,28 +353,39 @@ int y, x;
 /* Map the current area plus some			-RAK-	*/
 void map_area()
 {
+  static cave_plane around;
   register cave_type *c_ptr;
-  register int i7, i8, n, m;
-  int i, j, k, l;
+  register int n, m, w;
+  int i, j, k, l, t;
+  int64u bits;
 
   i = panel_row_min - randint(10);
   j = panel_row_max + randint(10);
   k = panel_col_min - randint(20);
   l = panel_col_max + randint(20);
-  for (m = i; m <= j; m++)
-    for (n = k; n <= l; n++)
-      if (in_bounds(m, n) && (cave[m][n].fval <= MAX_CAVE_FLOOR))
-	for (i7 = m-1; i7 <= m+1; i7++)
-	  for (i8 = n-1; i8 <= n+1; i8++)
-	    {
-	      c_ptr = &cave[i7][i8];
-	      if (c_ptr->fval >= MIN_CAVE_WALL)
-		c_ptr->pl = true;
-	      else if ((c_ptr->tptr != 0) &&
-		       (t_list[c_ptr->tptr].tval >= TV_MIN_VISIBLE) &&
-		       (t_list[c_ptr->tptr].tval <= TV_MAX_VISIBLE))
-		c_ptr->fm = true;
-	    }
+  /* walls next to a floor square of the area are lit, and visible
+     objects on or next to one are marked */
+  cave_near_floor(around, i, k, j, l);
+  /* only squares on or next to the area can be marked, so look no further
+     than that, however big the level is */
+  for (m = (i > 0) ? i - 1 : 0; m <= j + 1 && m < cur_height; m++)
+    for (w = ((k > 0) ? k - 1 : 0) >> 6; w <= (l + 1) >> 6 && w < CAVE_WORDS;
+	 w++)
+      for (n = w << 6, bits = around[m][w]; bits != 0; n++, bits >>= 1)
+	if ((bits & 1) && (cave[m][n].fval >= MIN_CAVE_WALL))
+	  cave_on(cave_pl, m, n);
+  for (t = MIN_TRIX; t < tcptr; t++)
+    {
+      m = t_row[t];
+      n = t_col[t];
+      c_ptr = &cave[m][n];
+      if ((c_ptr->tptr == t) && cave_flag(around, m, n) &&
+	  (c_ptr->fval < MIN_CAVE_WALL) &&
+	  (t_list[t].tval >= TV_MIN_VISIBLE) &&
+	  (t_list[t].tval <= TV_MAX_VISIBLE))
+	cave_on(cave_fm, m, n);
+    }
+  screen_map_reset();
   prt_map();
 }
 
@@ -467,7 +496,7 @@ int door_creation()
 		(void) delete_object(i, j);
 	      k = popt();
 	      c_ptr->fval = BLOCKED_FLOOR;
-	      c_ptr->tptr = k;
+	      set_tptr(i, j, k);
 	      invcopy(&t_list[k], OBJ_CLOSED_DOOR);
 	      lite_spot(i, j);
 	    }
@@ -559,7 +588,7 @@ int dir, y, x;
   register int i;
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   int dist, flag;
   vtype out_val, m_name;
 
@@ -574,10 +603,10 @@ int dir, y, x;
 	flag = true;
       else
 	{
-	  if (!c_ptr->pl && !c_ptr->tl)
+	  if (!cave_flag(cave_pl, y, x) && !cave_flag(cave_tl, y, x))
 	    {
 	      /* set pl so that lite_spot will work */
-	      c_ptr->pl = true;
+	      cave_on(cave_pl, y, x);
 	      if (c_ptr->fval == LIGHT_FLOOR)
 		{
 		  if (panel_contains(y, x))
@@ -587,7 +616,7 @@ int dir, y, x;
 		lite_spot(y, x);
 	    }
 	  /* set pl in case tl was true above */
-	  c_ptr->pl = true;
+	  cave_on(cave_pl, y, x);
 	  if (c_ptr->cptr > 1)
 	    {
 	      m_ptr = &m_list[c_ptr->cptr];
@@ -665,7 +694,7 @@ int dir, y, x;
 	    t_ptr->p1 = 0;  /* Locked or jammed doors become merely closed. */
 	  else if (t_ptr->tval == TV_SECRET_DOOR)
 	    {
-	      c_ptr->fm = true;
+	      cave_on(cave_fm, y, x);
 	      change_trap(y, x);
 	      disarm = true;
 	    }
@@ -739,25 +768,22 @@ void fire_bolt(typ, dir, y, x, dam, bolt_typ)
 int typ, dir, y, x, dam;
 char *bolt_typ;
 {
-  int i, oldy, oldx, dist, flag;
+  int i, dist, flag;
   int32u weapon_type; int harm_type;
   int (*dummy)();
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val, m_name;
 
   flag = false;
   get_flags(typ, &weapon_type, &harm_type, &dummy);
-  oldy = y;
-  oldx = x;
   dist = 0;
   do
     {
       (void) mmove(dir, &y, &x);
       dist++;
       c_ptr = &cave[y][x];
-      lite_spot(oldy, oldx);
       if ((dist > OBJ_BOLT_RANGE) || c_ptr->fval >= MIN_CLOSED_SPACE)
 	flag = true;
       else
@@ -767,13 +793,15 @@ char *bolt_typ;
 	      flag = true;
 	      m_ptr = &m_list[c_ptr->cptr];
 	      r_ptr = &c_list[m_ptr->mptr];
+	      /* show the bolt's flight before the hit */
+	      anim_flush();
 
 	      /* light up monster and draw monster, temporarily set
 		 pl so that update_mon() will work */
-	      i = c_ptr->pl;
-	      c_ptr->pl = true;
+	      i = cave_flag(cave_pl, y, x);
+	      cave_on(cave_pl, y, x);
 	      update_mon ((int)c_ptr->cptr);
-	      c_ptr->pl = i;
+	      cave_put(cave_pl, y, x, i);
 	      /* draw monster and clear previous bolt */
 	      put_qio();
 
@@ -809,15 +837,68 @@ char *bolt_typ;
 	    }
 	  else if (panel_contains(y, x) && (py.flags.blind < 1))
 	    {
-	      print('*', y, x);
-	      /* show the bolt */
-	      put_qio();
+	      /* queue the bolt's next step */
+	      anim_frame();
+	      anim_cell('*', y, x);
 	    }
 	}
-      oldy = y;
-      oldx = x;
     }
   while (!flag);
+  anim_flush();
+}
+
+
+/* Fill in blast_mask[]					*/
+static void blast_init()
+{
+  register int i, j;
+  register blast_type *b_ptr;
+
+  for (i = -OBJ_BALL_RADIUS; i <= OBJ_BALL_RADIUS; i++)
+    for (j = -OBJ_BALL_RADIUS; j <= OBJ_BALL_RADIUS; j++)
+      if (distance(0, 0, i, j) <= OBJ_BALL_RADIUS)
+	{
+	  b_ptr = &blast_mask[blast_num++];
+	  b_ptr->dy = i;
+	  b_ptr->dx = j;
+	  b_ptr->dis = distance(0, 0, i, j);
+	  b_ptr->len = los_path(i, j, b_ptr->path_y, b_ptr->path_x);
+	}
+}
+
+
+/* Gather the squares an explosion centred on y, x reaches: those in
+   bounds, within range, and in line of sight of the centre.  The whole
+   area is found before anything in it is hurt.  Returns the number of
+   squares, which are put in area_y[], area_x[] with their distances
+   from the centre in area_dis[].				*/
+static int blast_area(y, x, area_y, area_x, area_dis)
+int y, x;
+int *area_y, *area_x, *area_dis;
+{
+  register int k, l, num;
+  register blast_type *b_ptr;
+
+  if (blast_num == 0)
+    blast_init();
+  num = 0;
+  for (k = 0; k < blast_num; k++)
+    {
+      b_ptr = &blast_mask[k];
+      if (!in_bounds(y + b_ptr->dy, x + b_ptr->dx))
+	continue;
+      for (l = 0; l < b_ptr->len; l++)
+	if (cave[y + b_ptr->path_y[l]][x + b_ptr->path_x[l]].fval
+	    >= MIN_CLOSED_SPACE)
+	  break;
+      if (l < b_ptr->len)
+	continue;
+      area_y[num] = y + b_ptr->dy;
+      area_x[num] = x + b_ptr->dx;
+      area_dis[num] = b_ptr->dis;
+      num++;
+    }
+  return(num);
 }
 
 
@@ -828,18 +909,18 @@ int typ, dir, y, x, dam_hp;
 char *descrip;
 {
   register int i, j;
-  int dam, max_dis, thit, tkill, k, tmp;
+  int dam, thit, tkill, k, tmp, n, num;
   int oldy, oldx, dist, flag, harm_type;
+  int area_y[BLAST_SIZE], area_x[BLAST_SIZE], area_dis[BLAST_SIZE];
   int32u weapon_type;
   int (*destroy)();
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val;
 
   thit	 = 0;
   tkill	 = 0;
-  max_dis = 2;
   get_flags(typ, &weapon_type, &harm_type, &destroy);
   flag = false;
   oldy = y;
@@ -849,7 +930,6 @@ char *descrip;
     {
       (void) mmove(dir, &y, &x);
       dist++;
-      lite_spot(oldy, oldx);
       if (dist > OBJ_BOLT_RANGE)
 	flag = true;
       else
@@ -864,61 +944,65 @@ char *descrip;
 		  x = oldx;
 		}
 	      /* The ball hits and explodes.		     */
+	      anim_flush();
 	      /* The explosion.			     */
-	      for (i = y-max_dis; i <= y+max_dis; i++)
-		for (j = x-max_dis; j <= x+max_dis; j++)
-		  if (in_bounds(i, j) && (distance(y, x, i, j) <= max_dis)
-		      && los(y, x, i, j))
+	      anim_frame();
+	      num = blast_area(y, x, area_y, area_x, area_dis);
+	      for (n = 0; n < num; n++)
+		{
+		  i = area_y[n];
+		  j = area_x[n];
+		  c_ptr = &cave[i][j];
+		  if ((c_ptr->tptr != 0) &&
+		      (*destroy)(&t_list[c_ptr->tptr]))
+		    (void) delete_object(i, j);
+		  if (c_ptr->fval <= MAX_OPEN_SPACE)
 		    {
-		      c_ptr = &cave[i][j];
-		      if ((c_ptr->tptr != 0) &&
-			  (*destroy)(&t_list[c_ptr->tptr]))
-			(void) delete_object(i, j);
-		      if (c_ptr->fval <= MAX_OPEN_SPACE)
+		      if (c_ptr->cptr > 1)
 			{
-			  if (c_ptr->cptr > 1)
+			  m_ptr = &m_list[c_ptr->cptr];
+			  r_ptr = &c_list[m_ptr->mptr];
+
+			  /* lite up creature if visible, temp
+			     set pl so that update_mon works */
+			  tmp = cave_flag(cave_pl, i, j);
+			  cave_on(cave_pl, i, j);
+			  update_mon((int)c_ptr->cptr);
+
+			  thit++;
+			  dam = dam_hp;
+			  if (harm_type & r_ptr->cdefense)
+			    {
+			      dam = dam*2;
+			      if (m_ptr->ml)
+				c_recall[m_ptr->mptr].r_cdefense |=harm_type;
+			    }
+			  else if (weapon_type & r_ptr->spells)
 			    {
-			      m_ptr = &m_list[c_ptr->cptr];
-			      r_ptr = &c_list[m_ptr->mptr];
-
-			      /* lite up creature if visible, temp
-				 set pl so that update_mon works */
-			      tmp = c_ptr->pl;
-			      c_ptr->pl = true;
-			      update_mon((int)c_ptr->cptr);
-
-			      thit++;
-			      dam = dam_hp;
-			      if (harm_type & r_ptr->cdefense)
-				{
-				  dam = dam*2;
-				  if (m_ptr->ml)
-				    c_recall[m_ptr->mptr].r_cdefense |=harm_type;
-				}
-			      else if (weapon_type & r_ptr->spells)
-				{
-				  dam = dam / 4;
-				  if (m_ptr->ml)
-				    c_recall[m_ptr->mptr].r_spells |=weapon_type;
-				}
-			      dam = (dam/(distance(i, j, y, x)+1));
-			      k = mon_take_hit((int)c_ptr->cptr, dam);
-			      if (k >= 0)
-				tkill++;
-			      c_ptr->pl = tmp;
+			      dam = dam / 4;
+			      if (m_ptr->ml)
+				c_recall[m_ptr->mptr].r_spells |=weapon_type;
 			    }
-			  else if (panel_contains(i, j) &&(py.flags.blind < 1))
-			    print('*', i, j);
+			  dam = (dam/(area_dis[n]+1));
+			  k = mon_take_hit((int)c_ptr->cptr, dam);
+			  if (k >= 0)
+			    tkill++;
+			  cave_put(cave_pl, i, j, tmp);
 			}
+		      else if (panel_contains(i, j) &&(py.flags.blind < 1))
+			anim_cell('*', i, j);
 		    }
+		}
 	      /* show ball of whatever */
-	      put_qio();
+	      anim_show();
 
-	      for (i = (y - 2); i <= (y + 2); i++)
-		for (j = (x - 2); j <= (x + 2); j++)
-		  if (in_bounds(i, j) && panel_contains(i, j) &&
-		      (distance(y, x, i, j) <= max_dis))
+	      for (n = 0; n < blast_num; n++)
+		{
+		  i = y + blast_mask[n].dy;
+		  j = x + blast_mask[n].dx;
+		  if (in_bounds(i, j) && panel_contains(i, j))
 		    lite_spot(i, j);
+		}
 
 	      /* End  explosion.		     */
 	      if (thit == 1)
@@ -945,15 +1029,16 @@ char *descrip;
 	    }
 	  else if (panel_contains(y, x) && (py.flags.blind < 1))
 	    {
-	      print('*', y, x);
-	      /* show bolt */
-	      put_qio();
+	      /* queue the ball's next step */
+	      anim_frame();
+	      anim_cell('*', y, x);
 	    }
 	  oldy = y;
 	  oldx = x;
 	}
     }
   while (!flag);
+  anim_flush();
 }
 
 
@@ -965,109 +1050,117 @@ char *ddesc;
 int monptr;
 {
   register int i, j;
-  int dam, max_dis, harm_type;
+  int dam, harm_type, n, num;
+  int area_y[BLAST_SIZE], area_x[BLAST_SIZE], area_dis[BLAST_SIZE];
   int32u weapon_type;
   int32u tmp, treas;
   int (*destroy)();
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
 #ifdef ATARIST_MWC
   int32u holder;
 #endif
 
-  max_dis = 2;
   get_flags(typ, &weapon_type, &harm_type, &destroy);
-  for (i = y-2; i <= y+2; i++)
-    for (j = x-2; j <= x+2; j++)
-      if (in_bounds(i, j) && (distance(y, x, i, j) <= max_dis)
-	  && los(y, x, i, j))
+  num = blast_area(y, x, area_y, area_x, area_dis);
+  /* show the ball of gas before anything in it is hurt */
+  anim_frame();
+  for (n = 0; n < num; n++)
+    {
+      i = area_y[n];
+      j = area_x[n];
+      /* must test status bit, not py.flags.blind here, flag could have
+	 been set by a previous monster, but the breath should still
+	 be visible until the blindness takes effect */
+      if ((cave[i][j].fval <= MAX_OPEN_SPACE) && panel_contains(i, j)
+	  && !(py.flags.status & PY_BLIND))
+	anim_cell('*', i, j);
+    }
+  anim_show();
+
+  for (n = 0; n < num; n++)
+    {
+      i = area_y[n];
+      j = area_x[n];
+      c_ptr = &cave[i][j];
+      if ((c_ptr->tptr != 0) &&
+	  (*destroy)(&t_list[c_ptr->tptr]))
+	(void) delete_object(i, j);
+      if (c_ptr->fval <= MAX_OPEN_SPACE)
 	{
-	  c_ptr = &cave[i][j];
-	  if ((c_ptr->tptr != 0) &&
-	      (*destroy)(&t_list[c_ptr->tptr]))
-	    (void) delete_object(i, j);
-	  if (c_ptr->fval <= MAX_OPEN_SPACE)
+	  if (c_ptr->cptr > 1)
 	    {
-	      /* must test status bit, not py.flags.blind here, flag could have
-		 been set by a previous monster, but the breath should still
-		 be visible until the blindness takes effect */
-	      if (panel_contains(i, j) && !(py.flags.status & PY_BLIND))
-		print('*', i, j);
-	      if (c_ptr->cptr > 1)
+	      m_ptr = &m_list[c_ptr->cptr];
+	      r_ptr = &c_list[m_ptr->mptr];
+	      dam = dam_hp;
+	      if (harm_type & r_ptr->cdefense)
+		dam = dam*2;
+	      else if (weapon_type & r_ptr->spells)
+		dam = (dam / 4);
+	      dam = (dam/(area_dis[n]+1));
+	      /* can not call mon_take_hit here, since player does not
+		 get experience for kill */
+	      m_ptr->hp = m_ptr->hp - dam;
+	      m_ptr->csleep = 0;
+	      if (m_ptr->hp < 0)
 		{
-		  m_ptr = &m_list[c_ptr->cptr];
-		  r_ptr = &c_list[m_ptr->mptr];
-		  dam = dam_hp;
-		  if (harm_type & r_ptr->cdefense)
-		    dam = dam*2;
-		  else if (weapon_type & r_ptr->spells)
-		    dam = (dam / 4);
-		  dam = (dam/(distance(i, j, y, x)+1));
-		  /* can not call mon_take_hit here, since player does not
-		     get experience for kill */
-		  m_ptr->hp = m_ptr->hp - dam;
-		  m_ptr->csleep = 0;
-		  if (m_ptr->hp < 0)
+		  treas = monster_death((int)m_ptr->fy, (int)m_ptr->fx,
+					r_ptr->cmove);
+		  event_log(EV_KILL, r_ptr->name, 0L);
+		  if (m_ptr->ml)
 		    {
-		      treas = monster_death((int)m_ptr->fy, (int)m_ptr->fx,
-					    r_ptr->cmove);
-		      if (m_ptr->ml)
-			{
 #ifdef ATARIST_MWC
-			  holder = CM_TREASURE;
-			  tmp = (c_recall[m_ptr->mptr].r_cmove & holder)
-			    >> CM_TR_SHIFT;
-			  if (tmp > ((treas & holder) >> CM_TR_SHIFT))
-			    treas = (treas & ~holder)|(tmp << CM_TR_SHIFT);
-			  c_recall[m_ptr->mptr].r_cmove = treas |
-			    (c_recall[m_ptr->mptr].r_cmove & ~holder);
+		      holder = CM_TREASURE;
+		      tmp = (c_recall[m_ptr->mptr].r_cmove & holder)
+			>> CM_TR_SHIFT;
+		      if (tmp > ((treas & holder) >> CM_TR_SHIFT))
+			treas = (treas & ~holder)|(tmp << CM_TR_SHIFT);
+		      c_recall[m_ptr->mptr].r_cmove = treas |
+			(c_recall[m_ptr->mptr].r_cmove & ~holder);
 #else
-			  tmp = (c_recall[m_ptr->mptr].r_cmove & CM_TREASURE)
-			    >> CM_TR_SHIFT;
-			  if (tmp > ((treas & CM_TREASURE) >> CM_TR_SHIFT))
-			    treas = (treas & ~CM_TREASURE)|(tmp<<CM_TR_SHIFT);
-			  c_recall[m_ptr->mptr].r_cmove = treas |
-			    (c_recall[m_ptr->mptr].r_cmove & ~CM_TREASURE);
+		      tmp = (c_recall[m_ptr->mptr].r_cmove & CM_TREASURE)
+			>> CM_TR_SHIFT;
+		      if (tmp > ((treas & CM_TREASURE) >> CM_TR_SHIFT))
+			treas = (treas & ~CM_TREASURE)|(tmp<<CM_TR_SHIFT);
+		      c_recall[m_ptr->mptr].r_cmove = treas |
+			(c_recall[m_ptr->mptr].r_cmove & ~CM_TREASURE);
 #endif
-			}
-
-		      /* It ate an already processed monster.Handle normally.*/
-		      if (monptr < c_ptr->cptr)
-			delete_monster((int) c_ptr->cptr);
-		      /* If it eats this monster, an already processed monster
-			 will take its place, causing all kinds of havoc.
-			 Delay the kill a bit. */
-		      else
-			fix1_delete_monster((int) c_ptr->cptr);
 		    }
+
+		  /* It ate an already processed monster.Handle normally.*/
+		  if (monptr < c_ptr->cptr)
+		    delete_monster((int) c_ptr->cptr);
+		  /* If it eats this monster, an already processed monster
+		     will take its place, causing all kinds of havoc.
+		     Delay the kill a bit. */
+		  else
+		    fix1_delete_monster((int) c_ptr->cptr);
 		}
-	      else if (c_ptr->cptr == 1)
+	    }
+	  else if (c_ptr->cptr == 1)
+	    {
+	      dam = (dam_hp/(area_dis[n]+1));
+	      /* let's do at least one point of damage */
+	      /* prevents randint(0) problem with poison_gas, also */
+	      if (dam == 0)
+		dam = 1;
+	      switch(typ)
 		{
-		  dam = (dam_hp/(distance(i, j, y, x)+1));
-		  /* let's do at least one point of damage */
-		  /* prevents randint(0) problem with poison_gas, also */
-		  if (dam == 0)
-		    dam = 1;
-		  switch(typ)
-		    {
-		    case GF_LIGHTNING: light_dam(dam, ddesc); break;
-		    case GF_POISON_GAS: poison_gas(dam, ddesc); break;
-		    case GF_ACID: acid_dam(dam, ddesc); break;
-		    case GF_FROST: cold_dam(dam, ddesc); break;
-		    case GF_FIRE: fire_dam(dam, ddesc); break;
-		    }
+		case GF_LIGHTNING: light_dam(dam, ddesc); break;
+		case GF_POISON_GAS: poison_gas(dam, ddesc); break;
+		case GF_ACID: acid_dam(dam, ddesc); break;
+		case GF_FROST: cold_dam(dam, ddesc); break;
+		case GF_FIRE: fire_dam(dam, ddesc); break;
 		}
 	    }
 	}
-  /* show the ball of gas */
-  put_qio();
+    }
 
-  for (i = (y - 2); i <= (y + 2); i++)
-    for (j = (x - 2); j <= (x + 2); j++)
-      if (in_bounds(i, j) && panel_contains(i, j) &&
-	  (distance(y, x, i, j) <= max_dis))
-	lite_spot(i, j);
+  /* put back the squares the gas was shown on */
+  for (n = 0; n < num; n++)
+    if (panel_contains(area_y[n], area_x[n]))
+      lite_spot(area_y[n], area_x[n]);
 }
 
 
@@ -1123,7 +1216,7 @@ int dir, y, x, dam;
   int flag, dist, monster;
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val, m_name;
 
   monster = false;
@@ -1170,7 +1263,7 @@ int dir, y, x;
   int flag, dist, drain;
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val, m_name;
 
   drain = false;
@@ -1222,7 +1315,7 @@ int dir, y, x, spd;
   int flag, dist, speed;
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val, m_name;
 
   speed = false;
@@ -1277,7 +1370,7 @@ int dir, y, x;
   int flag, dist, confuse;
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val, m_name;
 
   confuse = false;
@@ -1333,7 +1426,7 @@ int dir, y, x;
   int flag, dist, sleep;
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val, m_name;
 
   sleep = false;
@@ -1383,7 +1476,7 @@ int dir, y, x;
   register int flag;
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype m_name;
 
   wall = false;
@@ -1513,7 +1606,7 @@ int dir, y, x;
 {
   int dist, flag, poly;
   register cave_type *c_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   register monster_type *m_ptr;
   vtype out_val, m_name;
 
@@ -1539,8 +1632,9 @@ int dir, y, x;
 	      poly = place_monster(y, x,
 				   randint(m_level[MAX_MONS_LEVEL]-m_level[0])
 				   - 1 + m_level[0], false);
-	      /* don't test c_ptr->fm here, only pl/tl */
-	      if (poly && panel_contains(y, x) && (c_ptr->tl || c_ptr->pl))
+	      /* don't test fm here, only pl/tl */
+	      if (poly && panel_contains(y, x) &&
+		  (cave_flag(cave_tl, y, x) || cave_flag(cave_pl, y, x)))
 		poly = true;
 	    }
 	  else
@@ -1564,7 +1658,7 @@ int dir, y, x;
   int build, damage, dist, flag;
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype m_name, out_val;
 #ifdef ATARIST_MWC
   int32u holder;
@@ -1623,9 +1717,11 @@ int dir, y, x;
 		}
 	    }
 	  c_ptr->fval  = MAGMA_WALL;
-	  c_ptr->fm = false;
+	  cave_off(cave_fm, y, x);
+	  flow_reset();
 	  /* Permanently light this wall if it is lit by player's lamp.  */
-	  c_ptr->pl = (c_ptr->tl || c_ptr->pl);
+	  if (cave_flag(cave_tl, y, x))
+	    cave_on(cave_pl, y, x);
 	  lite_spot(y, x);
 	  i++;
 	  build = true;
@@ -1707,7 +1803,6 @@ int ny, nx;
 {
   int dis, ctr, y, x;
   register int i, j;
-  register cave_type *c_ptr;
 
   dis = 1;
   ctr = 0;
@@ -1728,8 +1823,7 @@ int ny, nx;
   for (i = char_row-1; i <= char_row+1; i++)
     for (j = char_col-1; j <= char_col+1; j++)
       {
-	c_ptr = &cave[i][j];
-	c_ptr->tl = false;
+	cave_off(cave_tl, i, j);
 	lite_spot(i, j);
       }
   lite_spot(char_row, char_col);
@@ -1776,7 +1870,7 @@ int mass_genocide()
 {
   register int i, result;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
 #ifdef ATARIST_MWC
   int32u holder;
 #endif
@@ -1808,7 +1902,7 @@ int genocide()
   register int i, killed;
   char typ;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val;
 #ifdef ATARIST_MWC
   int32u holder;
@@ -1850,7 +1944,7 @@ int spd;
 {
   register int i, speed;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val, m_name;
 
   speed = false;
@@ -1902,7 +1996,7 @@ int sleep_monsters2()
 {
   register int i, sleep;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val, m_name;
 
   sleep = false;
@@ -1948,7 +2042,7 @@ int mass_poly()
   register int i;
   int y, x, mass;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
 #ifdef ATARIST_MWC
   int32u holder;
 #endif
@@ -2120,13 +2214,14 @@ void earthquake()
   register int i, j;
   register cave_type *c_ptr;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   int damage, tmp;
   vtype out_val, m_name;
 #ifdef ATARIST_MWC
   int32u holder;
 #endif
 
+  flow_reset();
   for (i = char_row-8; i <= char_row+8; i++)
     for (j = char_col-8; j <= char_col+8; j++)
       if (((i != char_row) || (j != char_col)) &&
@@ -2174,8 +2269,8 @@ void earthquake()
 	  if ((c_ptr->fval >= MIN_CAVE_WALL) && (c_ptr->fval != BOUNDARY_WALL))
 	    {
 	      c_ptr->fval  = CORR_FLOOR;
-	      c_ptr->pl = false;
-	      c_ptr->fm = false;
+	      cave_off(cave_pl, i, j);
+	      cave_off(cave_fm, i, j);
 	    }
 	  else if (c_ptr->fval <= MAX_CAVE_FLOOR)
 	    {
@@ -2187,7 +2282,7 @@ void earthquake()
 	      else
 		c_ptr->fval  = GRANITE_WALL;
 
-	      c_ptr->fm = false;
+	      cave_off(cave_fm, i, j);
 	    }
 	  lite_spot(i, j);
 	}
@@ -2240,7 +2335,7 @@ int damage;
   register int i;
   int k, dispel;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val, m_name;
 
   dispel = false;
@@ -2276,7 +2371,7 @@ int turn_undead()
 {
   register int i, turn_und;
   register monster_type *m_ptr;
-  register creature_type *r_ptr;
+  register creature_type const *r_ptr;
   vtype out_val, m_name;
 
   turn_und = false;
@@ -2322,7 +2417,7 @@ void warding_glyph()
   if (c_ptr->tptr == 0)
     {
       i = popt();
-      c_ptr->tptr = i;
+      set_tptr(char_row, char_col, i);
       invcopy(&t_list[i], OBJ_SCARE_MON);
     }
 }
@@ -2412,7 +2507,7 @@ int32 amount;
 {
   register int i;
   register struct misc *m_ptr;
-  register class_type *c_ptr;
+  register class_type const *c_ptr;
 
   m_ptr = &py.misc;
   if (amount > m_ptr->exp)
@@ -2489,6 +2584,7 @@ int y, x, typ;
 {
   register cave_type *c_ptr;
 
+  flow_reset();
   c_ptr = &cave[y][x];
   switch(typ)
     {
@@ -2505,9 +2601,9 @@ int y, x, typ;
       c_ptr->fval  = QUARTZ_WALL;
       break;
     }
-  c_ptr->pl = false;
-  c_ptr->fm = false;
-  c_ptr->lr = false;  /* this is no longer part of a room */
+  cave_off(cave_pl, y, x);
+  cave_off(cave_fm, y, x);
+  cave_off(cave_lr, y, x);  /* this is no longer part of a room */
   if (c_ptr->tptr != 0)
     (void) delete_object(y, x);
   if (c_ptr->cptr > 1)
@@ -2538,6 +2634,7 @@ register int y, x;
 	      else if (k < 16)
 		replace_spot(i, j, randint(9));
 	    }
+      screen_map_reset();
     }
   msg_print("There is a searing blast of light!");
   py.flags.blind += 10 + randint(10);
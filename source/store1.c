@@ -52,7 +52,7 @@ register inven_type *i_ptr;
 	   ((i_ptr->tval >= TV_BOOTS) && (i_ptr->tval <= TV_SOFT_ARMOR)))
     {	/* Weapons and armor	*/
       if (!known2_p(i_ptr))
-	value = object_list[i_ptr->index].cost;
+	value = object_cost(i_ptr->index);
       else if ((i_ptr->tval >= TV_BOW) && (i_ptr->tval <= TV_SWORD))
 	{
 	  if (i_ptr->tohit < 0)
@@ -75,7 +75,7 @@ register inven_type *i_ptr;
   else if ((i_ptr->tval >= TV_SLING_AMMO) && (i_ptr->tval <= TV_SPIKE))
     {	/* Ammo			*/
       if (!known2_p(i_ptr))
-	value = object_list[i_ptr->index].cost;
+	value = object_cost(i_ptr->index);
       else
 	{
 	  if (i_ptr->tohit < 0)
@@ -111,7 +111,7 @@ register inven_type *i_ptr;
 	/* player knows what type of ring, but does not know whether it is
 	   cursed or not, if refuse to buy cursed objects here, then
 	   player can use this to 'identify' cursed objects */
-	value = object_list[i_ptr->index].cost;
+	value = object_cost(i_ptr->index);
     }
   else if ((i_ptr->tval == TV_STAFF) || (i_ptr->tval == TV_WAND))
     {	/* Wands and staffs*/
@@ -129,7 +129,7 @@ register inven_type *i_ptr;
   else if (i_ptr->tval == TV_DIGGING)
     {
       if (!known2_p(i_ptr))
-	value = object_list[i_ptr->index].cost;
+	value = object_cost(i_ptr->index);
       else
 	{
 	  if (i_ptr->p1 < 0)
@@ -233,7 +233,7 @@ int store_num;
 int *ipos;
 inven_type *t_ptr;
 {
-  int item_num, item_val, flag;
+  int item_num, item_val, flag, lo, hi;
   register int typ, subt;
   int32 icost, dummy;
   register inven_type *i_ptr;
@@ -243,50 +243,51 @@ inven_type *t_ptr;
   if (sell_price(store_num, &icost, &dummy, t_ptr) > 0)
     {
       s_ptr = &store[store_num];
-      item_val = 0;
       item_num = t_ptr->number;
       flag = false;
       typ  = t_ptr->tval;
       subt = t_ptr->subval;
-      do
+      /* The list is sorted by decreasing tval, find where this tval
+	 starts.  */
+      lo = 0;
+      hi = s_ptr->store_ctr;
+      while (lo < hi)
+	{
+	  item_val = (lo + hi) / 2;
+	  if (s_ptr->store_inven[item_val].sitem.tval > typ)
+	    lo = item_val + 1;
+	  else
+	    hi = item_val;
+	}
+      for (item_val = lo; (item_val < s_ptr->store_ctr) && !flag &&
+	   (s_ptr->store_inven[item_val].sitem.tval == typ); item_val++)
 	{
 	  i_ptr = &s_ptr->store_inven[item_val].sitem;
-	  if (typ == i_ptr->tval)
+	  if (subt == i_ptr->subval && /* Adds to other item	*/
+	      subt >= ITEM_SINGLE_STACK_MIN
+	      && (subt < ITEM_GROUP_MIN || i_ptr->p1 == t_ptr->p1))
 	    {
-	      if (subt == i_ptr->subval && /* Adds to other item	*/
-		  subt >= ITEM_SINGLE_STACK_MIN
-		  && (subt < ITEM_GROUP_MIN || i_ptr->p1 == t_ptr->p1))
+	      *ipos = item_val;
+	      i_ptr->number += item_num;
+	      /* must set new scost for group items, do this only for items
+		 strictly greater than group_min, not for torches, this
+		 must be recalculated for entire group */
+	      if (subt > ITEM_GROUP_MIN)
 		{
-		  *ipos = item_val;
-		  i_ptr->number += item_num;
-		  /* must set new scost for group items, do this only for items
-		     strictly greater than group_min, not for torches, this
-		     must be recalculated for entire group */
-		  if (subt > ITEM_GROUP_MIN)
-		    {
-		      (void) sell_price (store_num, &icost, &dummy, i_ptr);
-		      s_ptr->store_inven[item_val].scost = -icost;
-		    }
-		  /* must let group objects (except torches) stack over 24
-		     since there may be more than 24 in the group */
-		  else if (i_ptr->number > 24)
-		    i_ptr->number = 24;
-		  flag = true;
+		  (void) sell_price (store_num, &icost, &dummy, i_ptr);
+		  s_ptr->store_inven[item_val].scost = -icost;
 		}
-	    }
-	  else if (typ > i_ptr->tval)
-	    {		/* Insert into list		*/
-	      insert_store(store_num, item_val, icost, t_ptr);
+	      /* must let group objects (except torches) stack over 24
+		 since there may be more than 24 in the group */
+	      else if (i_ptr->number > 24)
+		i_ptr->number = 24;
 	      flag = true;
-	      *ipos = item_val;
 	    }
-	  item_val++;
 	}
-      while ((item_val < s_ptr->store_ctr) && (!flag));
-      if (!flag)	/* Becomes last item in list	*/
+      if (!flag)	/* Goes after the others of its tval	*/
 	{
-	  insert_store(store_num, (int)s_ptr->store_ctr, icost, t_ptr);
-	  *ipos = s_ptr->store_ctr - 1;
+	  insert_store(store_num, item_val, icost, t_ptr);
+	  *ipos = item_val;
 	}
     }
 }
@@ -389,7 +390,7 @@ int store_num;
       tries++;
     }
   while (tries <= 3);
-  pusht((int8u)cur_pos);
+  pusht((dindex)cur_pos);
 }
 
 
@@ -423,6 +424,31 @@ void store_maint()
     }
 }
 
+/* Store turnovers put off until the player is back in town */
+static int store_pending = 0;
+
+/* Turn over the store contents, or only count the turnover if the
+   player would rather it was done on return to town.		*/
+void store_turnover()
+{
+  if (!lazy_store_flag)
+    store_maint();
+  else if (store_pending < STORE_MAX_PENDING)
+    store_pending++;
+}
+
+
+/* Do all the turnovers put off by store_turnover().		*/
+void store_catch_up()
+{
+  while (store_pending > 0)
+    {
+      store_pending--;
+      store_maint();
+    }
+}
+
+
 /* eliminate need to bargain if player has haggled well in the past   -DJB- */
 int noneedtobargain(store_num, minprice)
 int store_num;
@@ -41,6 +41,7 @@ static void prt_comment5(void);
 static void prt_comment6(void);
 static void display_commands(void);
 static void haggle_commands(int);
+static char *store_desc(int, int);
 static void display_inventory(int, int);
 static void display_cost(int, int);
 static void store_prt_gold(void);
@@ -64,6 +65,15 @@ static int store_sell(int, int *);
 
 long atol();
 
+/* The last description display_inventory() made for each store slot, and
+   the item it described, so that the screen can be redrawn without
+   describing every unchanged item again.  */
+static struct store_desc_type
+{
+  inven_type item;
+  bigvtype desc;
+} store_descs[MAX_STORES][STORE_INVEN_MAX];
+
 static char *comment1[14] = {
   "Done!",  "Accepted!",  "Fine.",  "Agreed!",  "Ok.",  "Taken!",
   "You drive a hard bargain, but taken.",
@@ -238,14 +248,39 @@ int typ;
 }
 
 
+/* Describe the item in a store slot, reusing the last description if
+   the item has not changed since.				*/
+static char *store_desc(store_num, pos)
+int store_num, pos;
+{
+  register inven_type *i_ptr;
+  register struct store_desc_type *d_ptr;
+  int x;
+
+  i_ptr = &store[store_num].store_inven[pos].sitem;
+  d_ptr = &store_descs[store_num][pos];
+  if (d_ptr->desc[0] == '\0'
+      || memcmp((char *)&d_ptr->item, (char *)i_ptr, sizeof(inven_type)))
+    {
+      d_ptr->item = *i_ptr;
+      x = i_ptr->number;
+      if ((i_ptr->subval >= ITEM_SINGLE_STACK_MIN)
+	  && (i_ptr->subval <= ITEM_SINGLE_STACK_MAX))
+	i_ptr->number = 1;
+      objdes(d_ptr->desc, i_ptr, true);
+      i_ptr->number = x;
+    }
+  return(d_ptr->desc);
+}
+
+
 /* Displays a store's inventory				-RAK-	*/
 static void display_inventory(store_num, start)
 int store_num, start;
 {
   register store_type *s_ptr;
-  register inven_type *i_ptr;
   register int i, j, stop;
-  bigvtype out_val1, out_val2;
+  bigvtype out_val2;
   int32 x;
 
   s_ptr = &store[store_num];
@@ -254,14 +289,7 @@ int store_num, start;
   if (stop > s_ptr->store_ctr)	stop = s_ptr->store_ctr;
   while (start < stop)
     {
-      i_ptr = &s_ptr->store_inven[start].sitem;
-      x = i_ptr->number;
-      if ((i_ptr->subval >= ITEM_SINGLE_STACK_MIN)
-	  && (i_ptr->subval <= ITEM_SINGLE_STACK_MAX))
-	i_ptr->number = 1;
-      objdes(out_val1, i_ptr, true);
-      i_ptr->number = x;
-      (void) sprintf(out_val2, "%c) %s", 'a'+i, out_val1);
+      (void) sprintf(out_val2, "%c) %s", 'a'+i, store_desc(store_num, start));
       prt(out_val2, i+5, 0);
       x = s_ptr->store_inven[start].scost;
       if (x <= 0)
@@ -552,7 +580,7 @@ inven_type *item;
   vtype out_val;
   int purchase, num_offer, final_flag, didnt_haggle;
   register store_type *s_ptr;
-  register owner_type *o_ptr;
+  register owner_type const *o_ptr;
 
   flag = false;
   purchase = 0;
@@ -712,7 +740,7 @@ inven_type *item;
   char *comment;
   vtype out_val;
   register store_type *s_ptr;
-  register owner_type *o_ptr;
+  register owner_type const *o_ptr;
   int sell, num_offer, final_flag, didnt_haggle;
 
   flag = false;
@@ -940,6 +968,7 @@ int *cur_top;
 		  i = s_ptr->store_ctr;
 		  store_destroy(store_num, item_val, true);
 		  objdes(tmp_str, &inventory[item_new], true);
+		  event_log(EV_PURCHASE, tmp_str, price);
 		  (void) sprintf(out_val, "You have %s (%c)",
 				   tmp_str, item_new+'a');
 		  prt(out_val, 0, 0);
@@ -1101,6 +1130,7 @@ int store_num;
   s_ptr = &store[store_num];
   if (s_ptr->store_open < turn)
     {
+      store_catch_up();
       exit_flag = false;
       cur_top = 0;
       display_store(store_num, cur_top);
@@ -44,7 +44,7 @@ store_type store[MAX_STORES];
 #ifdef MACGAME
 owner_type *owners;
 #else
-owner_type owners[MAX_OWNERS] = {
+owner_type const owners[MAX_OWNERS] = {
 {"Erick the Honest       (Human)      General Store",
 	  250,	175,  108,    4, 0, 12},
 {"Mauglin the Grumpy     (Dwarf)      Armory"	    ,
@@ -86,7 +86,7 @@ owner_type owners[MAX_OWNERS] = {
 
 /* Buying and selling adjustments for character race VS store	*/
 /* owner race							 */
-int8u rgold_adj[MAX_RACES][MAX_RACES] = {
+int8u const rgold_adj[MAX_RACES][MAX_RACES] = {
 			/*  Hum,  HfE,	Elf,  Hal,  Gno,  Dwa,	HfO,  HfT*/
 /*Human		 */	  {  100,  105,	 105,  110,  113,  115,	 120,  125},
 /*Half-Elf	 */	  {  110,  100,	 100,  105,  110,  120,	 125,  130},
@@ -98,7 +98,7 @@ int8u rgold_adj[MAX_RACES][MAX_RACES] = {
 /*Half-Troll	 */	  {  110,  115,	 115,  110,  110,  130,	 110,  110}
 			};
 /* object_list[] index of objects that may appear in the store */
-int16u store_choice[MAX_STORES][STORE_CHOICES] = {
+int16u const store_choice[MAX_STORES][STORE_CHOICES] = {
 	/* General Store */
 {366,365,364,84,84,365,123,366,365,350,349,348,347,346,346,345,345,345,
 	344,344,344,344,344,344,344,344},
@@ -127,7 +127,7 @@ extern int general_store(), armory(), weaponsmith(), temple(),
   alchemist(), magic_shop();
 
 /* Each store will buy only certain items, based on TVAL */
-int (*store_buy[MAX_STORES])() = {
+int (*const store_buy[MAX_STORES])() = {
        general_store, armory, weaponsmith, temple, alchemist, magic_shop};
 #endif
 
@@ -145,7 +145,9 @@ char **syllables;
 
 #else
 
-char *colors[MAX_COLORS] = {
+/* The flavor names themselves are read-only; magic_init() copies them into
+   colors[], mushrooms[] etc. below and shuffles those for each game */
+char *const color_names[MAX_COLORS] = {
 /* Do not move the first three */
   "Icky Green", "Light Brown", "Clear",
   "Azure","Blue","Blue Speckled","Black","Brown","Brown Speckled","Bubbling",
@@ -158,27 +160,27 @@ char *colors[MAX_COLORS] = {
   "Tangerine","Violet","Vermilion","White","Yellow"
 };
 
-char *mushrooms[MAX_MUSH] = {
+char *const mushroom_names[MAX_MUSH] = {
   "Blue","Black","Black Spotted","Brown","Dark Blue","Dark Green","Dark Red",
   "Ecru","Furry","Green","Grey","Light Blue","Light Green","Plaid","Red",
   "Slimy","Tan","White","White Spotted","Wooden","Wrinkled","Yellow",
 };
 
-char *woods[MAX_WOODS] = {
+char *const wood_names[MAX_WOODS] = {
   "Aspen","Balsa","Banyan","Birch","Cedar","Cottonwood","Cypress","Dogwood",
   "Elm","Eucalyptus","Hemlock","Hickory","Ironwood","Locust","Mahogany",
   "Maple","Mulberry","Oak","Pine","Redwood","Rosewood","Spruce","Sycamore",
   "Teak","Walnut",
 };
 
-char *metals[MAX_METALS] = {
+char *const metal_names[MAX_METALS] = {
   "Aluminum","Cast Iron","Chromium","Copper","Gold","Iron","Magnesium",
   "Molybdenum","Nickel","Rusty","Silver","Steel","Tin","Titanium","Tungsten",
   "Zirconium","Zinc","Aluminum-Plated","Copper-Plated","Gold-Plated",
   "Nickel-Plated","Silver-Plated","Steel-Plated","Tin-Plated","Zinc-Plated"
 };
 
-char *rocks[MAX_ROCKS] = {
+char *const rock_names[MAX_ROCKS] = {
   "Alexandrite","Amethyst","Aquamarine","Azurite","Beryl","Bloodstone",
   "Calcite","Carnelian","Corundum","Diamond","Emerald","Fluorite","Garnet",
   "Granite","Jade","Jasper","Lapis Lazuli","Malachite","Marble","Moonstone",
@@ -186,12 +188,19 @@ char *rocks[MAX_ROCKS] = {
   "Tiger Eye","Topaz","Turquoise","Zircon"
 };
 
-char *amulets[MAX_AMULETS] = {
+char *const amulet_names[MAX_AMULETS] = {
   "Amber","Driftwood","Coral","Agate","Ivory","Obsidian",
   "Bone","Brass","Bronze","Pewter","Tortoise Shell"
 };
 
-char *syllables[MAX_SYLLABLES] = {
+char *colors[MAX_COLORS];
+char *mushrooms[MAX_MUSH];
+char *woods[MAX_WOODS];
+char *metals[MAX_METALS];
+char *rocks[MAX_ROCKS];
+char *amulets[MAX_AMULETS];
+
+char *const syllables[MAX_SYLLABLES] = {
   "a","ab","ag","aks","ala","an","ankh","app",
   "arg","arze","ash","aus","ban","bar","bat","bek",
   "bie","bin","bit","bjor","blu","bot","bu",
@@ -216,7 +225,7 @@ char *syllables[MAX_SYLLABLES] = {
 #endif
 
 /* used to calculate the number of blows the player gets in combat */
-int8u blows_table[7][6] = {
+int8u const blows_table[7][6] = {
 /* STR/W:	   9  18  67 107 117 118   : DEX */
 /* <2 */	{  1,  1,  1,  1,  1,  1 },
 /* <3 */	{  1,  1,  1,  1,  2,  2 },
@@ -230,7 +239,7 @@ int8u blows_table[7][6] = {
 /* this table is used to generate a psuedo-normal distribution.	 See the
    function randnor() in misc1.c, this is much faster than calling
    transcendental function to calculate a true normal distribution */
-int16u normal_table[NORMAL_TABLE_SIZE] = {
+int16u const normal_table[NORMAL_TABLE_SIZE] = {
      206,     613,    1022,    1430,	1838,	 2245,	  2652,	   3058,
     3463,    3867,    4271,    4673,	5075,	 5475,	  5874,	   6271,
     6667,    7061,    7454,    7845,	8234,	 8621,	  9006,	   9389,
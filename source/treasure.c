@@ -77,7 +77,7 @@
 #if defined(MACGAME) || defined(RSRC_PART2)
 treasure_type *object_list;
 #else
-treasure_type object_list[MAX_OBJECTS] = {
+treasure_type const object_list[MAX_OBJECTS] = {
 /* Dungeon items from 0 to MAX_DUNGEON_OBJ */
 {"Poison"			,0x00000001L,	TV_FOOD, ',',	/*  0*/
   500,	   0,	64,   1,   1,	0,   0,	 0,   0, {0,0}	,  7},
@@ -952,7 +952,7 @@ treasure_type object_list[MAX_OBJECTS] = {
 };
 #endif
 
-char *special_names[SN_ARRAY_SIZE] = {
+char *const special_names[SN_ARRAY_SIZE] = {
 	CNIL,			"(R)",			"(RA)",
 	"(RF)",			"(RC)",			"(RL)",
 	"(HA)",			"(DF)",			"(SA)",
@@ -976,12 +976,13 @@ char *special_names[SN_ARRAY_SIZE] = {
 
 /* Pairing things down for THINK C.  */
 #ifndef RSRC_PART2
-int16 sorted_objects[MAX_DUNGEON_OBJ];
+/* sorted_objects and t_level are generated from object_list at build
+   time, see mktables.c */
 
 /* Identified objects flags					*/
 int8u object_ident[OBJECT_IDENT_SIZE];
-int16 t_level[MAX_OBJ_LEVEL+1];
 inven_type t_list[MAX_TALLOC];
+dcoord t_row[MAX_TALLOC], t_col[MAX_TALLOC];	/* Where t_list objects are */
 inven_type inventory[INVEN_ARRAY_SIZE];
 #endif
 
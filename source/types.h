@@ -29,6 +29,23 @@ typedef int_least16_t  int16;
 typedef uint_least16_t int16u;
 typedef int_least32_t  int32;
 typedef uint_least32_t int32u;
+typedef uint_least64_t int64u;
+
+/* A map coordinate, or a distance across the map, as kept in the monster
+   and object lists.  A byte is enough for the usual 66 by 198 dungeon. */
+#ifdef LARGE_DUNGEON
+typedef int16u dcoord;
+#else
+typedef int8u  dcoord;
+#endif
+
+/* An index into m_list or t_list as kept in a cave square.  The large
+   dungeon has more than 255 of each. */
+#ifdef LARGE_DUNGEON
+typedef int16u dindex;
+#else
+typedef int8u  dindex;
+#endif
 
 /* some machines will not accept 'signed char' as a type, and some accept it
    but still treat it like an unsigned character, let's just avoid it,
@@ -97,13 +114,20 @@ typedef struct monster_type
   int16  csleep; /* Inactive counter     */
   int16  cspeed; /* Movement speed       */
   int16u mptr;   /* Pointer into creature*/
-  /* Note: fy, fx, and cdis constrain dungeon size to less than 256 by 256 */
-  int8u  fy;     /* Y Pointer into map   */
-  int8u  fx;     /* X Pointer into map   */
-  int8u  cdis;   /* Cur dis from player  */
+  /* Note: fy, fx, and cdis constrain dungeon size to less than 256 by 256,
+     unless LARGE_DUNGEON is defined */
+  dcoord fy;     /* Y Pointer into map   */
+  dcoord fx;     /* X Pointer into map   */
+  dcoord cdis;   /* Cur dis from player  */
   int8u  ml;
   int8u  stunned;
   int8u  confused;
+  /* copied from c_list by cache_monster(), so that the per-turn code in
+     creature.c need not look there */
+  int8u  aaf;      /* Area affect radius    */
+  int8u  level;    /* Level of creature     */
+  int32u cmove;    /* Bit field             */
+  int16u cdefense; /* Bit field             */
 } monster_type;
 
 typedef struct treasure_type
@@ -328,21 +352,22 @@ typedef struct background_type
 
 typedef struct cave_type
 {
-  int8u cptr;
-  int8u tptr;
+  dindex cptr;
+  dindex tptr;
   int8u fval;
-  /* room should be lit with perm light, walls with this set should be perm
-     lit after tunneled out */
-  bool  lr : 1;
-  /* field mark, used for traps/doors/stairs, object is hidden if fm is
-     false */
-  bool  fm : 1;
-  /* permanent light, used for walls and lighted rooms */
-  bool  pl : 1;
-  /* temporary light, used for player's lamp light,etc.*/
-  bool  tl : 1;
 } cave_type;
 
+/* The per-square lighting flags are kept out of cave_type, one bit plane
+   per flag, so that whole rows of them can be set, cleared and tested a
+   word at a time; see CAVE_BIT() in config.h.  The planes are:
+   cave_lr: room should be lit with perm light, walls with this set should
+            be perm lit after tunneled out
+   cave_fm: field mark, used for traps/doors/stairs, object is hidden if fm
+            is false
+   cave_pl: permanent light, used for walls and lighted rooms
+   cave_tl: temporary light, used for player's lamp light,etc. */
+typedef int64u cave_plane[MAX_HEIGHT][CAVE_WORDS];
+
 typedef struct owner_type
 {
   char *owner_name;
@@ -389,4 +414,13 @@ typedef struct high_scores
   char died_from[DIED_FROM_SIZE];
 } high_scores;
 
+/* A data file built into the game, see cmake/embed_assets.cmake */
+typedef struct asset_type
+{
+  char const *name;     /* File name, without the directory      */
+  char const *text;     /* Contents, newlines but no returns      */
+  int32u const *lines;  /* Where each line starts, and the end    */
+  int16u line_count;
+} asset_type;
+
 #endif /* TYPES_H */
@@ -50,8 +50,6 @@ int16 cur_height,cur_width;	/* Cur dungeon size    */
 int16 dun_level = 0;		/* Cur dungeon level   */
 int16 missile_ctr = 0;		/* Counter for missiles */
 int msg_flag;			/* Set with first msg  */
-vtype old_msg[MAX_SAVE_MSG];	/* Last message	      */
-int16 last_msg = 0;		/* Where last is held */
 int death = false;		/* True if died	      */
 int find_flag;			/* Used in MORIA for .(dir) */
 int free_turn_flag;		/* Used in MORIA, do not move creatures  */
@@ -76,6 +74,9 @@ int highlight_seams = false;
 int find_ignore_doors = false;
 int sound_beep_flag = true;
 int display_counts = true;
+int skip_anim_flag = false;
+int smart_path_flag = false;
+int lazy_store_flag = false;
 
 char doing_inven = false;	/* Track inventory commands. -CJS- */
 int screen_change = false;	/* Track screen updates for inven_commands. */
@@ -91,8 +92,8 @@ int light_flag = false;		/* Track if temporary light about player.  */
 int wait_for_more = false;	/* used when ^C hit during -more- prompt */
 int closing_flag = false;	/* Used for closing   */
 
-/*  Following are calculated from max dungeon sizes		*/
-int16 max_panel_rows,max_panel_cols;
+/*  Size of the map view, see init_curses()			*/
+int view_height = SCREEN_HEIGHT, view_width = SCREEN_WIDTH;
 int panel_row,panel_col;
 int panel_row_min,panel_row_max;
 int panel_col_min,panel_col_max;
@@ -103,6 +104,7 @@ cave_type (*cave)[MAX_WIDTH];
 #else
 cave_type cave[MAX_HEIGHT][MAX_WIDTH];
 #endif
+cave_plane cave_lr, cave_fm, cave_pl, cave_tl;
 
 #ifdef MAC
 recall_type *c_recall;
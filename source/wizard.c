@@ -42,25 +42,25 @@ long atol();
 /* Light up the dungeon					-RAK-	*/
 void wizard_light()
 {
-  register cave_type *c_ptr;
-  register int k, l, i, j;
+  static cave_plane around;
+  register int i, w;
   int flag;
 
-  if (cave[char_row][char_col].pl)
+  if (cave_flag(cave_pl, char_row, char_col))
     flag = false;
   else
     flag = true;
+  cave_near_floor(around, 0, 0, cur_height - 1, cur_width - 1);
   for (i = 0; i < cur_height; i++)
-    for (j = 0; j < cur_width; j++)
-      if (cave[i][j].fval <= MAX_CAVE_FLOOR)
-	for (k = i-1; k <= i+1; k++)
-	  for (l = j-1; l <= j+1; l++)
-	    {
-	      c_ptr = &cave[k][l];
-	      c_ptr->pl = flag;
-	      if (!flag)
-		c_ptr->fm = false;
-	    }
+    for (w = 0; w < CAVE_WORDS; w++)
+      if (flag)
+	cave_pl[i][w] |= around[i][w];
+      else
+	{
+	  cave_pl[i][w] &= ~around[i][w];
+	  cave_fm[i][w] &= ~around[i][w];
+	}
+  screen_map_reset();
   prt_map();
 }
 
@@ -417,9 +417,32 @@ void wizard_create()
 
       tmp_val = popt();
       t_list[tmp_val] = forge;
-      c_ptr->tptr = tmp_val;
+      set_tptr(char_row, char_col, tmp_val);
       msg_print("Allocated.");
     }
   else
     msg_print("Aborted.");
 }
+
+
+/* Show the hot path profiling counters */
+void wizard_profile()
+{
+#ifdef PROFILE
+  register int i;
+  bigvtype out_val;
+
+  save_screen();
+  prt("Calls and cycles (including counted callees) so far:", 0, 0);
+  for (i = 0; i < PROF_MAX; i++)
+    {
+      prof_describe(i, out_val);
+      prt(out_val, i + 1, 0);
+    }
+  erase_line(PROF_MAX + 1, 0);
+  pause_line(PROF_MAX + 1);
+  restore_screen();
+#else
+  msg_print("This game was built without profiling counters.");
+#endif
+}